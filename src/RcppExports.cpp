@@ -30,6 +30,372 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// admin_grid_points
+List admin_grid_points(Environment& addr_hash_map, CharacterVector& keys);
+RcppExport SEXP _baidugeo_admin_grid_points(SEXP addr_hash_mapSEXP, SEXP keysSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment& >::type addr_hash_map(addr_hash_mapSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    rcpp_result_gen = Rcpp::wrap(admin_grid_points(addr_hash_map, keys));
+    return rcpp_result_gen;
+END_RCPP
+}
+// admin_grid_build
+List admin_grid_build(NumericVector& lat, NumericVector& lon, IntegerVector& label, double cell_size, double min_share, int min_points);
+RcppExport SEXP _baidugeo_admin_grid_build(SEXP latSEXP, SEXP lonSEXP, SEXP labelSEXP, SEXP cell_sizeSEXP, SEXP min_shareSEXP, SEXP min_pointsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector& >::type lat(latSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type lon(lonSEXP);
+    Rcpp::traits::input_parameter< IntegerVector& >::type label(labelSEXP);
+    Rcpp::traits::input_parameter< double >::type cell_size(cell_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type min_share(min_shareSEXP);
+    Rcpp::traits::input_parameter< int >::type min_points(min_pointsSEXP);
+    rcpp_result_gen = Rcpp::wrap(admin_grid_build(lat, lon, label, cell_size, min_share, min_points));
+    return rcpp_result_gen;
+END_RCPP
+}
+// admin_grid_lookup
+IntegerVector admin_grid_lookup(List& grid, NumericVector& lat, NumericVector& lon);
+RcppExport SEXP _baidugeo_admin_grid_lookup(SEXP gridSEXP, SEXP latSEXP, SEXP lonSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List& >::type grid(gridSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type lat(latSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type lon(lonSEXP);
+    rcpp_result_gen = Rcpp::wrap(admin_grid_lookup(grid, lat, lon));
+    return rcpp_result_gen;
+END_RCPP
+}
+// admin_grid_answers
+CharacterVector admin_grid_answers(NumericVector& lat, NumericVector& lon, CharacterVector& province, CharacterVector& city, CharacterVector& district, IntegerVector& ad_code);
+RcppExport SEXP _baidugeo_admin_grid_answers(SEXP latSEXP, SEXP lonSEXP, SEXP provinceSEXP, SEXP citySEXP, SEXP districtSEXP, SEXP ad_codeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector& >::type lat(latSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type lon(lonSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type province(provinceSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type city(citySEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type district(districtSEXP);
+    Rcpp::traits::input_parameter< IntegerVector& >::type ad_code(ad_codeSEXP);
+    rcpp_result_gen = Rcpp::wrap(admin_grid_answers(lat, lon, province, city, district, ad_code));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_journal_open
+SEXP cache_journal_open(std::string path);
+RcppExport SEXP _baidugeo_cache_journal_open(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_journal_open(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_journal_lock
+void cache_journal_lock(SEXP journal, bool exclusive);
+RcppExport SEXP _baidugeo_cache_journal_lock(SEXP journalSEXP, SEXP exclusiveSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    Rcpp::traits::input_parameter< bool >::type exclusive(exclusiveSEXP);
+    cache_journal_lock(journal, exclusive);
+    return R_NilValue;
+END_RCPP
+}
+// cache_journal_unlock
+void cache_journal_unlock(SEXP journal);
+RcppExport SEXP _baidugeo_cache_journal_unlock(SEXP journalSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    cache_journal_unlock(journal);
+    return R_NilValue;
+END_RCPP
+}
+// cache_journal_generation
+double cache_journal_generation(SEXP journal);
+RcppExport SEXP _baidugeo_cache_journal_generation(SEXP journalSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_journal_generation(journal));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_journal_start
+double cache_journal_start();
+RcppExport SEXP _baidugeo_cache_journal_start() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(cache_journal_start());
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_journal_append
+void cache_journal_append(SEXP journal, CharacterVector& keys, List& values, NumericVector& inserted);
+RcppExport SEXP _baidugeo_cache_journal_append(SEXP journalSEXP, SEXP keysSEXP, SEXP valuesSEXP, SEXP insertedSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< List& >::type values(valuesSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type inserted(insertedSEXP);
+    cache_journal_append(journal, keys, values, inserted);
+    return R_NilValue;
+END_RCPP
+}
+// cache_journal_append_tracker
+void cache_journal_append_tracker(SEXP journal, CharacterVector& keys, NumericVector& times, bool evict);
+RcppExport SEXP _baidugeo_cache_journal_append_tracker(SEXP journalSEXP, SEXP keysSEXP, SEXP timesSEXP, SEXP evictSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< bool >::type evict(evictSEXP);
+    cache_journal_append_tracker(journal, keys, times, evict);
+    return R_NilValue;
+END_RCPP
+}
+// cache_journal_read
+List cache_journal_read(SEXP journal, double offset, double generation, bool include_self);
+RcppExport SEXP _baidugeo_cache_journal_read(SEXP journalSEXP, SEXP offsetSEXP, SEXP generationSEXP, SEXP include_selfSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    Rcpp::traits::input_parameter< double >::type offset(offsetSEXP);
+    Rcpp::traits::input_parameter< double >::type generation(generationSEXP);
+    Rcpp::traits::input_parameter< bool >::type include_self(include_selfSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_journal_read(journal, offset, generation, include_self));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_journal_reset
+double cache_journal_reset(SEXP journal);
+RcppExport SEXP _baidugeo_cache_journal_reset(SEXP journalSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_journal_reset(journal));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_journal_size
+double cache_journal_size(SEXP journal);
+RcppExport SEXP _baidugeo_cache_journal_size(SEXP journalSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type journal(journalSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_journal_size(journal));
+    return rcpp_result_gen;
+END_RCPP
+}
+// seed_from_coords
+List seed_from_coords(Environment& coord_hash_map, CharacterVector& keys);
+RcppExport SEXP _baidugeo_seed_from_coords(SEXP coord_hash_mapSEXP, SEXP keysSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment& >::type coord_hash_map(coord_hash_mapSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    rcpp_result_gen = Rcpp::wrap(seed_from_coords(coord_hash_map, keys));
+    return rcpp_result_gen;
+END_RCPP
+}
+// seed_from_addrs
+List seed_from_addrs(Environment& addr_hash_map, CharacterVector& keys);
+RcppExport SEXP _baidugeo_seed_from_addrs(SEXP addr_hash_mapSEXP, SEXP keysSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment& >::type addr_hash_map(addr_hash_mapSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    rcpp_result_gen = Rcpp::wrap(seed_from_addrs(addr_hash_map, keys));
+    return rcpp_result_gen;
+END_RCPP
+}
+// is_derived_entry
+LogicalVector is_derived_entry(CharacterVector& json);
+RcppExport SEXP _baidugeo_is_derived_entry(SEXP jsonSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector& >::type json(jsonSEXP);
+    rcpp_result_gen = Rcpp::wrap(is_derived_entry(json));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_store_build
+List cache_store_build(Environment& hash_map, CharacterVector& keys, int block_size);
+RcppExport SEXP _baidugeo_cache_store_build(SEXP hash_mapSEXP, SEXP keysSEXP, SEXP block_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment& >::type hash_map(hash_mapSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< int >::type block_size(block_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_store_build(hash_map, keys, block_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_store_restore
+List cache_store_restore(Environment& hash_map, List& blocks, NumericVector& sizes);
+RcppExport SEXP _baidugeo_cache_store_restore(SEXP hash_mapSEXP, SEXP blocksSEXP, SEXP sizesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment& >::type hash_map(hash_mapSEXP);
+    Rcpp::traits::input_parameter< List& >::type blocks(blocksSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type sizes(sizesSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_store_restore(hash_map, blocks, sizes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_new
+SEXP cache_tracker_new();
+RcppExport SEXP _baidugeo_cache_tracker_new() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_new());
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_load
+void cache_tracker_load(SEXP tracker, CharacterVector& keys, NumericVector& inserted, NumericVector& accessed, LogicalVector& pending);
+RcppExport SEXP _baidugeo_cache_tracker_load(SEXP trackerSEXP, SEXP keysSEXP, SEXP insertedSEXP, SEXP accessedSEXP, SEXP pendingSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type inserted(insertedSEXP);
+    Rcpp::traits::input_parameter< NumericVector& >::type accessed(accessedSEXP);
+    Rcpp::traits::input_parameter< LogicalVector& >::type pending(pendingSEXP);
+    cache_tracker_load(tracker, keys, inserted, accessed, pending);
+    return R_NilValue;
+END_RCPP
+}
+// cache_tracker_insert
+void cache_tracker_insert(SEXP tracker, std::string key, double now);
+RcppExport SEXP _baidugeo_cache_tracker_insert(SEXP trackerSEXP, SEXP keySEXP, SEXP nowSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< std::string >::type key(keySEXP);
+    Rcpp::traits::input_parameter< double >::type now(nowSEXP);
+    cache_tracker_insert(tracker, key, now);
+    return R_NilValue;
+END_RCPP
+}
+// cache_tracker_touch
+void cache_tracker_touch(SEXP tracker, std::string key, double now);
+RcppExport SEXP _baidugeo_cache_tracker_touch(SEXP trackerSEXP, SEXP keySEXP, SEXP nowSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< std::string >::type key(keySEXP);
+    Rcpp::traits::input_parameter< double >::type now(nowSEXP);
+    cache_tracker_touch(tracker, key, now);
+    return R_NilValue;
+END_RCPP
+}
+// cache_tracker_remove
+void cache_tracker_remove(SEXP tracker, CharacterVector& keys);
+RcppExport SEXP _baidugeo_cache_tracker_remove(SEXP trackerSEXP, SEXP keysSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    cache_tracker_remove(tracker, keys);
+    return R_NilValue;
+END_RCPP
+}
+// cache_tracker_remove_before
+CharacterVector cache_tracker_remove_before(SEXP tracker, CharacterVector& keys, double time);
+RcppExport SEXP _baidugeo_cache_tracker_remove_before(SEXP trackerSEXP, SEXP keysSEXP, SEXP timeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< double >::type time(timeSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_remove_before(tracker, keys, time));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_is_expired
+bool cache_tracker_is_expired(SEXP tracker, std::string key, double now, double max_age);
+RcppExport SEXP _baidugeo_cache_tracker_is_expired(SEXP trackerSEXP, SEXP keySEXP, SEXP nowSEXP, SEXP max_ageSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< std::string >::type key(keySEXP);
+    Rcpp::traits::input_parameter< double >::type now(nowSEXP);
+    Rcpp::traits::input_parameter< double >::type max_age(max_ageSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_is_expired(tracker, key, now, max_age));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_evict
+CharacterVector cache_tracker_evict(SEXP tracker, double max_entries, double max_age, double now);
+RcppExport SEXP _baidugeo_cache_tracker_evict(SEXP trackerSEXP, SEXP max_entriesSEXP, SEXP max_ageSEXP, SEXP nowSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    Rcpp::traits::input_parameter< double >::type max_entries(max_entriesSEXP);
+    Rcpp::traits::input_parameter< double >::type max_age(max_ageSEXP);
+    Rcpp::traits::input_parameter< double >::type now(nowSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_evict(tracker, max_entries, max_age, now));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_take_pending
+CharacterVector cache_tracker_take_pending(SEXP tracker);
+RcppExport SEXP _baidugeo_cache_tracker_take_pending(SEXP trackerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_take_pending(tracker));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_size
+int cache_tracker_size(SEXP tracker);
+RcppExport SEXP _baidugeo_cache_tracker_size(SEXP trackerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_size(tracker));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cache_tracker_meta
+List cache_tracker_meta(SEXP tracker);
+RcppExport SEXP _baidugeo_cache_tracker_meta(SEXP trackerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type tracker(trackerSEXP);
+    rcpp_result_gen = Rcpp::wrap(cache_tracker_meta(tracker));
+    return rcpp_result_gen;
+END_RCPP
+}
 // from_json_coords_vector
 List from_json_coords_vector(CharacterVector location, std::vector<std::string> json_vect);
 RcppExport SEXP _baidugeo_from_json_coords_vector(SEXP locationSEXP, SEXP json_vectSEXP) {
@@ -54,6 +420,90 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// fuzzy_index_new
+SEXP fuzzy_index_new(CharacterVector& suffixes);
+RcppExport SEXP _baidugeo_fuzzy_index_new(SEXP suffixesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector& >::type suffixes(suffixesSEXP);
+    rcpp_result_gen = Rcpp::wrap(fuzzy_index_new(suffixes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fuzzy_index_add
+void fuzzy_index_add(SEXP index, CharacterVector& keys, CharacterVector& location);
+RcppExport SEXP _baidugeo_fuzzy_index_add(SEXP indexSEXP, SEXP keysSEXP, SEXP locationSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type location(locationSEXP);
+    fuzzy_index_add(index, keys, location);
+    return R_NilValue;
+END_RCPP
+}
+// fuzzy_index_remove
+void fuzzy_index_remove(SEXP index, CharacterVector& keys);
+RcppExport SEXP _baidugeo_fuzzy_index_remove(SEXP indexSEXP, SEXP keysSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type keys(keysSEXP);
+    fuzzy_index_remove(index, keys);
+    return R_NilValue;
+END_RCPP
+}
+// fuzzy_index_query
+List fuzzy_index_query(SEXP index, CharacterVector& location, double threshold);
+RcppExport SEXP _baidugeo_fuzzy_index_query(SEXP indexSEXP, SEXP locationSEXP, SEXP thresholdSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< CharacterVector& >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< double >::type threshold(thresholdSEXP);
+    rcpp_result_gen = Rcpp::wrap(fuzzy_index_query(index, location, threshold));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fuzzy_index_size
+int fuzzy_index_size(SEXP index);
+RcppExport SEXP _baidugeo_fuzzy_index_size(SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(fuzzy_index_size(index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fuzzy_index_capacity
+int fuzzy_index_capacity(SEXP index);
+RcppExport SEXP _baidugeo_fuzzy_index_capacity(SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(fuzzy_index_capacity(index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// normalize_locations
+CharacterVector normalize_locations(CharacterVector& location, bool width, bool whitespace, bool punctuation, bool lower_case);
+RcppExport SEXP _baidugeo_normalize_locations(SEXP locationSEXP, SEXP widthSEXP, SEXP whitespaceSEXP, SEXP punctuationSEXP, SEXP lower_caseSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector& >::type location(locationSEXP);
+    Rcpp::traits::input_parameter< bool >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< bool >::type whitespace(whitespaceSEXP);
+    Rcpp::traits::input_parameter< bool >::type punctuation(punctuationSEXP);
+    Rcpp::traits::input_parameter< bool >::type lower_case(lower_caseSEXP);
+    rcpp_result_gen = Rcpp::wrap(normalize_locations(location, width, whitespace, punctuation, lower_case));
+    return rcpp_result_gen;
+END_RCPP
+}
 // is_json_parsable
 bool is_json_parsable(const char * json);
 RcppExport SEXP _baidugeo_is_json_parsable(SEXP jsonSEXP) {
@@ -76,14 +526,63 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// classify_responses
+List classify_responses(CharacterVector& json);
+RcppExport SEXP _baidugeo_classify_responses(SEXP jsonSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector& >::type json(jsonSEXP);
+    rcpp_result_gen = Rcpp::wrap(classify_responses(json));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
     {"_baidugeo_from_json_addrs_vector", (DL_FUNC) &_baidugeo_from_json_addrs_vector, 3},
     {"_baidugeo_get_addrs_pkg_data", (DL_FUNC) &_baidugeo_get_addrs_pkg_data, 2},
+    {"_baidugeo_admin_grid_points", (DL_FUNC) &_baidugeo_admin_grid_points, 2},
+    {"_baidugeo_admin_grid_build", (DL_FUNC) &_baidugeo_admin_grid_build, 6},
+    {"_baidugeo_admin_grid_lookup", (DL_FUNC) &_baidugeo_admin_grid_lookup, 3},
+    {"_baidugeo_admin_grid_answers", (DL_FUNC) &_baidugeo_admin_grid_answers, 6},
+    {"_baidugeo_cache_journal_open", (DL_FUNC) &_baidugeo_cache_journal_open, 1},
+    {"_baidugeo_cache_journal_lock", (DL_FUNC) &_baidugeo_cache_journal_lock, 2},
+    {"_baidugeo_cache_journal_unlock", (DL_FUNC) &_baidugeo_cache_journal_unlock, 1},
+    {"_baidugeo_cache_journal_generation", (DL_FUNC) &_baidugeo_cache_journal_generation, 1},
+    {"_baidugeo_cache_journal_start", (DL_FUNC) &_baidugeo_cache_journal_start, 0},
+    {"_baidugeo_cache_journal_append", (DL_FUNC) &_baidugeo_cache_journal_append, 4},
+    {"_baidugeo_cache_journal_append_tracker", (DL_FUNC) &_baidugeo_cache_journal_append_tracker, 4},
+    {"_baidugeo_cache_journal_read", (DL_FUNC) &_baidugeo_cache_journal_read, 4},
+    {"_baidugeo_cache_journal_reset", (DL_FUNC) &_baidugeo_cache_journal_reset, 1},
+    {"_baidugeo_cache_journal_size", (DL_FUNC) &_baidugeo_cache_journal_size, 1},
+    {"_baidugeo_seed_from_coords", (DL_FUNC) &_baidugeo_seed_from_coords, 2},
+    {"_baidugeo_seed_from_addrs", (DL_FUNC) &_baidugeo_seed_from_addrs, 2},
+    {"_baidugeo_is_derived_entry", (DL_FUNC) &_baidugeo_is_derived_entry, 1},
+    {"_baidugeo_cache_store_build", (DL_FUNC) &_baidugeo_cache_store_build, 3},
+    {"_baidugeo_cache_store_restore", (DL_FUNC) &_baidugeo_cache_store_restore, 3},
+    {"_baidugeo_cache_tracker_new", (DL_FUNC) &_baidugeo_cache_tracker_new, 0},
+    {"_baidugeo_cache_tracker_load", (DL_FUNC) &_baidugeo_cache_tracker_load, 5},
+    {"_baidugeo_cache_tracker_insert", (DL_FUNC) &_baidugeo_cache_tracker_insert, 3},
+    {"_baidugeo_cache_tracker_touch", (DL_FUNC) &_baidugeo_cache_tracker_touch, 3},
+    {"_baidugeo_cache_tracker_remove", (DL_FUNC) &_baidugeo_cache_tracker_remove, 2},
+    {"_baidugeo_cache_tracker_remove_before", (DL_FUNC) &_baidugeo_cache_tracker_remove_before, 3},
+    {"_baidugeo_cache_tracker_is_expired", (DL_FUNC) &_baidugeo_cache_tracker_is_expired, 4},
+    {"_baidugeo_cache_tracker_evict", (DL_FUNC) &_baidugeo_cache_tracker_evict, 4},
+    {"_baidugeo_cache_tracker_take_pending", (DL_FUNC) &_baidugeo_cache_tracker_take_pending, 1},
+    {"_baidugeo_cache_tracker_size", (DL_FUNC) &_baidugeo_cache_tracker_size, 1},
+    {"_baidugeo_cache_tracker_meta", (DL_FUNC) &_baidugeo_cache_tracker_meta, 1},
     {"_baidugeo_from_json_coords_vector", (DL_FUNC) &_baidugeo_from_json_coords_vector, 2},
     {"_baidugeo_get_coords_pkg_data", (DL_FUNC) &_baidugeo_get_coords_pkg_data, 2},
+    {"_baidugeo_fuzzy_index_new", (DL_FUNC) &_baidugeo_fuzzy_index_new, 1},
+    {"_baidugeo_fuzzy_index_add", (DL_FUNC) &_baidugeo_fuzzy_index_add, 3},
+    {"_baidugeo_fuzzy_index_remove", (DL_FUNC) &_baidugeo_fuzzy_index_remove, 2},
+    {"_baidugeo_fuzzy_index_query", (DL_FUNC) &_baidugeo_fuzzy_index_query, 3},
+    {"_baidugeo_fuzzy_index_size", (DL_FUNC) &_baidugeo_fuzzy_index_size, 1},
+    {"_baidugeo_fuzzy_index_capacity", (DL_FUNC) &_baidugeo_fuzzy_index_capacity, 1},
+    {"_baidugeo_normalize_locations", (DL_FUNC) &_baidugeo_normalize_locations, 5},
     {"_baidugeo_is_json_parsable", (DL_FUNC) &_baidugeo_is_json_parsable, 1},
     {"_baidugeo_get_message_value", (DL_FUNC) &_baidugeo_get_message_value, 1},
+    {"_baidugeo_classify_responses", (DL_FUNC) &_baidugeo_classify_responses, 1},
     {NULL, NULL, 0}
 };
 
@@ -241,6 +241,14 @@ void from_json_addrs(std::string& json, std::string& key) {
   } else {
     addr_vars::city_code[0] = NA_REAL;
   }
+  
+  // derived (cache entries derived from other results, see cache_seed.cpp).
+  if(global_vars::doc.HasMember("derived") && 
+     global_vars::doc["derived"].IsString()) {
+    global_vars::derived = global_vars::doc["derived"].GetString();
+  } else {
+    global_vars::derived = NA_STRING;
+  }
 }
 
 
@@ -271,6 +279,7 @@ List from_json_addrs_vector(NumericVector lng, NumericVector lat,
   IntegerVector distance(json_len);
   CharacterVector sematic_desc(json_len);
   NumericVector city_code(json_len);
+  CharacterVector derived(json_len);
   
   rapidjson::Document doc;
   std::string na_str = "NA";
@@ -301,11 +310,12 @@ List from_json_addrs_vector(NumericVector lng, NumericVector lat,
     distance[i] = addr_vars::distance[0];
     sematic_desc[i] = addr_vars::sematic_desc;
     city_code[i] = addr_vars::city_code[0];
+    derived[i] = global_vars::derived;
   }
   
   // Create List output that has the necessary attributes to make it a
   // data.frame object.
-  List out(23);
+  List out(24);
   out[0] = input_lng;
   out[1] = input_lat;
   out[2] = return_lng;
@@ -329,8 +339,9 @@ List from_json_addrs_vector(NumericVector lng, NumericVector lat,
   out[20] = distance;
   out[21] = sematic_desc;
   out[22] = city_code;
+  out[23] = derived;
   
-  CharacterVector names(23);
+  CharacterVector names(24);
   names[0] = "input_lon";
   names[1] = "input_lat";
   names[2] = "return_lon";
@@ -354,6 +365,7 @@ List from_json_addrs_vector(NumericVector lng, NumericVector lat,
   names[20] = "distance";
   names[21] = "sematic_desc";
   names[22] = "city_code";
+  names[23] = "derived";
   
   out.attr("names") = names;
   out.attr("class") = "data.frame";
@@ -390,6 +402,7 @@ List get_addrs_pkg_data(Environment& addr_hash_map,
   IntegerVector distance(cache_len);
   CharacterVector sematic_desc(cache_len);
   NumericVector city_code(cache_len);
+  CharacterVector derived(cache_len);
   
   std::string curr_key;
   std::string curr_json;
@@ -423,11 +436,12 @@ List get_addrs_pkg_data(Environment& addr_hash_map,
     distance[i] = addr_vars::distance[0];
     sematic_desc[i] = addr_vars::sematic_desc;
     city_code[i] = addr_vars::city_code[0];
+    derived[i] = global_vars::derived;
   }
   
   // Create List output that has the necessary attributes to make it a
   // data.frame object.
-  List out(23);
+  List out(24);
   out[0] = input_lng;
   out[1] = input_lat;
   out[2] = return_lng;
@@ -451,8 +465,9 @@ List get_addrs_pkg_data(Environment& addr_hash_map,
   out[20] = distance;
   out[21] = sematic_desc;
   out[22] = city_code;
+  out[23] = derived;
   
-  CharacterVector names(23);
+  CharacterVector names(24);
   names[0] = "input_lon";
   names[1] = "input_lat";
   names[2] = "return_lon";
@@ -476,6 +491,7 @@ List get_addrs_pkg_data(Environment& addr_hash_map,
   names[20] = "distance";
   names[21] = "sematic_desc";
   names[22] = "city_code";
+  names[23] = "derived";
   
   out.attr("names") = names;
   out.attr("class") = "data.frame";
@@ -0,0 +1,251 @@
+#include <Rcpp.h>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+#include "baidugeo.h"
+using namespace Rcpp;
+
+
+// Grid raster of administrative regions (ad_code), built from the labeled
+// points of addr_hash_map, used to answer admin-level reverse geocoding
+// queries without an API call.
+//
+// The raster covers the bounding box of the labeled points, in square cells
+// of "cell_size" degrees. Cells are stored row-major (by lat, then lon) in
+// an integer vector, as 1-based indices into the table of region labels.
+// Cells that are not labeled hold one of the sentinels below, and lookups
+// of them fall back to the API.
+
+
+// Cell with no labeled points.
+static const int CELL_EMPTY = 0;
+// Cell whose points disagree on the region (i.e. a cell on a region border).
+static const int CELL_AMBIGUOUS = -1;
+// Cell with fewer than "min_points" labeled points.
+static const int CELL_SPARSE = -2;
+
+
+// Get a string member of a json object, or "" if it is missing.
+static std::string json_string(const rapidjson::Value& obj, const char* name) {
+  rapidjson::Value::ConstMemberIterator it = obj.FindMember(name);
+  if(it == obj.MemberEnd() || !it->value.IsString()) {
+    return "";
+  }
+  return it->value.GetString();
+}
+
+
+// Extract the labeled points of addr_hash_map: the input lat/lon (from the
+// cache key) and the region fields of every successful response that has
+// an ad_code. Derived entries (see cache_seed.cpp) are skipped.
+// [[Rcpp::export]]
+List admin_grid_points(Environment& addr_hash_map, CharacterVector& keys) {
+  int n = keys.size();
+  std::vector<double> lat;
+  std::vector<double> lng;
+  std::vector<int> ad_code;
+  std::vector<std::string> province;
+  std::vector<std::string> city;
+  std::vector<std::string> district;
+  rapidjson::Document doc;
+
+  for(int i = 0; i < n; ++i) {
+    std::string key = as<std::string>(keys[i]);
+    SEXP value = addr_hash_map.get(key);
+    if(TYPEOF(value) != STRSXP || Rf_length(value) != 1 ||
+       STRING_ELT(value, 0) == NA_STRING) {
+      continue;
+    }
+
+    doc.Parse(CHAR(STRING_ELT(value, 0)));
+    if(doc.HasParseError() || !doc.IsObject() || doc.HasMember("derived")) {
+      continue;
+    }
+    rapidjson::Value::ConstMemberIterator status = doc.FindMember("status");
+    if(status == doc.MemberEnd() || !status->value.IsNumber() ||
+       status->value.GetDouble() != 0) {
+      continue;
+    }
+    rapidjson::Value::ConstMemberIterator result = doc.FindMember("result");
+    if(result == doc.MemberEnd() || !result->value.IsObject()) {
+      continue;
+    }
+    rapidjson::Value::ConstMemberIterator comp =
+      result->value.FindMember("addressComponent");
+    if(comp == result->value.MemberEnd() || !comp->value.IsObject()) {
+      continue;
+    }
+    int code = atoi(json_string(comp->value, "adcode").c_str());
+    if(code <= 0) {
+      continue;
+    }
+
+    get_coords_from_uri(key);
+    lat.push_back(addr_vars::input_lat);
+    lng.push_back(addr_vars::input_lng);
+    ad_code.push_back(code);
+    province.push_back(json_string(comp->value, "province"));
+    city.push_back(json_string(comp->value, "city"));
+    district.push_back(json_string(comp->value, "district"));
+  }
+
+  int m = lat.size();
+  CharacterVector province_out(m);
+  CharacterVector city_out(m);
+  CharacterVector district_out(m);
+  for(int i = 0; i < m; ++i) {
+    province_out[i] = String(province[i], CE_UTF8);
+    city_out[i] = String(city[i], CE_UTF8);
+    district_out[i] = String(district[i], CE_UTF8);
+  }
+
+  return List::create(
+    Named("lat") = wrap(lat),
+    Named("lon") = wrap(lng),
+    Named("ad_code") = wrap(ad_code),
+    Named("province") = province_out,
+    Named("city") = city_out,
+    Named("district") = district_out
+  );
+}
+
+
+// Build the raster from labeled points. "label" gives the 1-based region
+// label of each point. A cell is labeled if it holds at least "min_points"
+// points, and at least a share "min_share" of them carry the same label.
+// [[Rcpp::export]]
+List admin_grid_build(NumericVector& lat, NumericVector& lon,
+                      IntegerVector& label, double cell_size,
+                      double min_share, int min_points) {
+  int n = lat.size();
+  double lat0 = R_PosInf;
+  double lon0 = R_PosInf;
+  double lat1 = R_NegInf;
+  double lon1 = R_NegInf;
+  for(int i = 0; i < n; ++i) {
+    lat0 = std::min(lat0, lat[i]);
+    lon0 = std::min(lon0, lon[i]);
+    lat1 = std::max(lat1, lat[i]);
+    lon1 = std::max(lon1, lon[i]);
+  }
+  int n_lat = 0;
+  int n_lon = 0;
+  if(n > 0) {
+    lat0 = std::floor(lat0 / cell_size) * cell_size;
+    lon0 = std::floor(lon0 / cell_size) * cell_size;
+    double n_lat_d = std::floor((lat1 - lat0) / cell_size) + 1;
+    double n_lon_d = std::floor((lon1 - lon0) / cell_size) + 1;
+    if(n_lat_d * n_lon_d > 1e8) {
+      stop("admin grid would exceed 1e8 cells, increase 'cell_size'");
+    }
+    n_lat = n_lat_d;
+    n_lon = n_lon_d;
+  }
+
+  // Sort the points by cell, then label each run of points in a cell.
+  std::vector<std::pair<int64_t, int> > points(n);
+  for(int i = 0; i < n; ++i) {
+    int64_t row = (int64_t) std::min(n_lat - 1.0,
+                                     std::floor((lat[i] - lat0) / cell_size));
+    int64_t col = (int64_t) std::min(n_lon - 1.0,
+                                     std::floor((lon[i] - lon0) / cell_size));
+    points[i] = std::make_pair(row * n_lon + col, (int) label[i]);
+  }
+  std::sort(points.begin(), points.end());
+
+  IntegerVector cells((size_t) n_lat * n_lon);
+  size_t start = 0;
+  while(start < points.size()) {
+    size_t end = start;
+    int best_label = 0;
+    int best_count = 0;
+    while(end < points.size() && points[end].first == points[start].first) {
+      size_t run = end;
+      while(end < points.size() && points[end] == points[run]) {
+        ++end;
+      }
+      if((int) (end - run) > best_count) {
+        best_count = end - run;
+        best_label = points[run].second;
+      }
+    }
+    int total = end - start;
+    if(total < min_points) {
+      cells[points[start].first] = CELL_SPARSE;
+    } else if(best_count >= min_share * total) {
+      cells[points[start].first] = best_label;
+    } else {
+      cells[points[start].first] = CELL_AMBIGUOUS;
+    }
+    start = end;
+  }
+
+  return List::create(
+    Named("lat0") = lat0,
+    Named("lon0") = lon0,
+    Named("cell_size") = cell_size,
+    Named("n_lat") = n_lat,
+    Named("n_lon") = n_lon,
+    Named("cells") = cells
+  );
+}
+
+
+// Look up the cell values of lat/lon points. Points outside the raster, or
+// with NA coordinates, get CELL_EMPTY.
+// [[Rcpp::export]]
+IntegerVector admin_grid_lookup(List& grid, NumericVector& lat,
+                                NumericVector& lon) {
+  double lat0 = grid["lat0"];
+  double lon0 = grid["lon0"];
+  double cell_size = grid["cell_size"];
+  int n_lat = grid["n_lat"];
+  int n_lon = grid["n_lon"];
+  IntegerVector cells = grid["cells"];
+
+  int n = lat.size();
+  IntegerVector out(n);
+  for(int i = 0; i < n; ++i) {
+    if(ISNAN(lat[i]) || ISNAN(lon[i])) {
+      continue;
+    }
+    double row = std::floor((lat[i] - lat0) / cell_size);
+    double col = std::floor((lon[i] - lon0) / cell_size);
+    if(row < 0 || row >= n_lat || col < 0 || col >= n_lon) {
+      continue;
+    }
+    out[i] = cells[(size_t) row * n_lon + (size_t) col];
+  }
+  return out;
+}
+
+
+// Build the json answers of grid lookups, in the format of the API: the
+// input lat/lon as "location", and the region fields of the cell label as
+// "addressComponent", marked with "derived":"admin_grid".
+// [[Rcpp::export]]
+CharacterVector admin_grid_answers(NumericVector& lat, NumericVector& lon,
+                                   CharacterVector& province,
+                                   CharacterVector& city,
+                                   CharacterVector& district,
+                                   IntegerVector& ad_code) {
+  int n = lat.size();
+  CharacterVector out(n);
+  for(int i = 0; i < n; ++i) {
+    std::string json = "{\"status\":0,\"result\":{\"location\":{\"lng\":";
+    append_number(lon[i], json);
+    json += ",\"lat\":";
+    append_number(lat[i], json);
+    json += "},\"addressComponent\":{\"province\":";
+    append_json_string(Rf_translateCharUTF8(STRING_ELT(province, i)), json);
+    json += ",\"city\":";
+    append_json_string(Rf_translateCharUTF8(STRING_ELT(city, i)), json);
+    json += ",\"district\":";
+    append_json_string(Rf_translateCharUTF8(STRING_ELT(district, i)), json);
+    json += ",\"adcode\":\"";
+    json += std::to_string(ad_code[i]);
+    json += "\"}},\"derived\":\"admin_grid\"}";
+    out[i] = String(json, CE_UTF8);
+  }
+  return out;
+}
@@ -15,6 +15,7 @@ namespace global_vars {
   extern NumericVector status;
   extern NumericVector lng;
   extern NumericVector lat;
+  extern String derived;
 }
 
 // Variables used by the coords functions.
@@ -51,9 +52,26 @@ namespace addr_vars {
 }
 
 
+// Result of classifying a single API response.
+struct ResponseClass {
+  double status;
+  std::string type;
+  std::string message;
+  bool has_message;
+};
+
+
 bool is_json_parsable(const char * json);
+ResponseClass classify_response(const char * json, size_t len);
 std::string get_message_value(const char * json);
 void get_coords_from_uri(std::string& uri);
+std::string normalize_location(const std::string& str, bool width,
+                               bool whitespace, bool punctuation,
+                               bool lower_case);
+void append_json_string(const std::string& str, std::string& out);
+void append_number(double x, std::string& out);
+std::string serialize_entry(SEXP value);
+CharacterVector unserialize_entry(const std::string& entry);
 
 
 #endif /* _ANAGRAMS_H */
@@ -0,0 +1,505 @@
+#include <Rcpp.h>
+#include <zlib.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <cstring>
+#include <stdint.h>
+#include <ctime>
+#include <random>
+#include "baidugeo.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <sys/file.h>
+#endif
+using namespace Rcpp;
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+
+// Append-only journal of cache inserts, shared by all R processes that use
+// the same cache file. Every insert is appended to the journal (under an
+// exclusive lock), and every process replays the records appended since its
+// own read offset, so inserts made by one process become visible to the
+// others without reloading the cache file. Accesses (touches) and
+// evictions are journaled the same way, so that the eviction tracker state
+// saved with the cache file reflects them, and so that entries evicted by
+// one process are not brought back by another. Each record is tagged with a
+// random id of the journal handle that wrote it, and readers skip their own
+// records, whose entries they already hold, except right after reloading
+// the cache file.
+//
+// File layout (native byte order, the journal is local to one machine):
+//   header:  8 byte magic "BMAPJNL1", uint64 generation
+//   records: uint32 record magic, uint32 writer id, uint32 key length,
+//            uint32 value length, double time, key bytes, value bytes
+//            (see serialize_entry()), uint32 adler32 of all preceding
+//            fields after the record magic.
+// The record magic tells the type of the record: an insert (time is the
+// insert time), a touch (time is the access time), or an eviction. Touch
+// and eviction records have no value bytes.
+//
+// When the journal is merged into the cache file (compaction), it is
+// truncated back to its header and its generation is incremented. A process
+// that finds a new generation reloads the cache file before replaying.
+//
+// A record left incomplete by a crashed writer is skipped: readers scan
+// forward to the next record magic with a valid checksum.
+
+static const char JOURNAL_MAGIC[8] = {'B', 'M', 'A', 'P', 'J', 'N', 'L', '1'};
+static const uint32_t RECORD_MAGIC = 0xB3A9C0DE;
+static const uint32_t TOUCH_MAGIC = 0xB3A9C1DE;
+static const uint32_t EVICT_MAGIC = 0xB3A9C2DE;
+static const int64_t HEADER_SIZE = 16;
+static const int64_t RECORD_OVERHEAD = 28;
+
+
+#ifdef _WIN32
+static int64_t seek_file(int fd, int64_t offset, int whence) {
+  return _lseeki64(fd, offset, whence);
+}
+
+static int truncate_file(int fd, int64_t size) {
+  return _chsize_s(fd, size);
+}
+
+static int current_pid() {
+  return _getpid();
+}
+
+// Lock a single byte far past the end of the data, as Windows locks are
+// mandatory and would otherwise block reads of the locked range.
+static bool lock_file(int fd, bool exclusive) {
+  HANDLE handle = (HANDLE) _get_osfhandle(fd);
+  OVERLAPPED overlapped;
+  memset(&overlapped, 0, sizeof(overlapped));
+  overlapped.OffsetHigh = 0x7FFFFFFF;
+  DWORD flags = exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+  return LockFileEx(handle, flags, 0, 1, 0, &overlapped) != 0;
+}
+
+static void unlock_file(int fd) {
+  HANDLE handle = (HANDLE) _get_osfhandle(fd);
+  OVERLAPPED overlapped;
+  memset(&overlapped, 0, sizeof(overlapped));
+  overlapped.OffsetHigh = 0x7FFFFFFF;
+  UnlockFileEx(handle, 0, 1, 0, &overlapped);
+}
+#else
+static int64_t seek_file(int fd, int64_t offset, int whence) {
+  return lseek(fd, offset, whence);
+}
+
+static int truncate_file(int fd, int64_t size) {
+  return ftruncate(fd, size);
+}
+
+static int current_pid() {
+  return getpid();
+}
+
+static bool lock_file(int fd, bool exclusive) {
+  int status;
+  do {
+    status = flock(fd, exclusive ? LOCK_EX : LOCK_SH);
+  } while(status != 0 && errno == EINTR);
+  return status == 0;
+}
+
+static void unlock_file(int fd) {
+  flock(fd, LOCK_UN);
+}
+#endif
+
+
+static bool read_fully(int fd, char* buf, int64_t len) {
+  while(len > 0) {
+    int n = read(fd, buf, len > (1 << 30) ? (1 << 30) : (unsigned int) len);
+    if(n <= 0) {
+      if(n < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+
+static bool write_fully(int fd, const char* buf, int64_t len) {
+  while(len > 0) {
+    int n = write(fd, buf, len > (1 << 30) ? (1 << 30) : (unsigned int) len);
+    if(n <= 0) {
+      if(n < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+
+class CacheJournal {
+public:
+  CacheJournal(const std::string& path) : path(path), fd(-1), locks(0) {
+    open_file();
+  }
+
+  ~CacheJournal() {
+    if(fd >= 0) {
+      close(fd);
+    }
+  }
+
+  // Locks are reentrant within a process. A shared lock requested while an
+  // exclusive lock is held keeps the exclusive lock.
+  void lock(bool exclusive) {
+    check_pid();
+    if(locks == 0 && !lock_file(fd, exclusive)) {
+      stop("unable to lock cache journal '" + path + "'");
+    }
+    ++locks;
+  }
+
+  void unlock() {
+    if(locks == 0) {
+      return;
+    }
+    if(--locks == 0) {
+      unlock_file(fd);
+    }
+  }
+
+  double generation() {
+    char header[HEADER_SIZE];
+    seek_file(fd, 0, SEEK_SET);
+    if(!read_fully(fd, header, HEADER_SIZE) ||
+       memcmp(header, JOURNAL_MAGIC, 8) != 0) {
+      stop("'" + path + "' is not a baidugeo cache journal");
+    }
+    uint64_t gen;
+    memcpy(&gen, header + 8, 8);
+    return (double) gen;
+  }
+
+  int64_t size() {
+    return seek_file(fd, 0, SEEK_END);
+  }
+
+  // Id of this handle, written to the records it appends.
+  uint32_t writer() {
+    check_pid();
+    return writer_id;
+  }
+
+  void append(const std::string& buf) {
+    seek_file(fd, 0, SEEK_END);
+    if(!write_fully(fd, buf.data(), buf.size())) {
+      stop("unable to write to cache journal '" + path + "'");
+    }
+  }
+
+  void read_from(int64_t offset, std::string& buf) {
+    int64_t end = size();
+    buf.resize(end > offset ? end - offset : 0);
+    seek_file(fd, offset, SEEK_SET);
+    if(!buf.empty() && !read_fully(fd, &buf[0], buf.size())) {
+      stop("unable to read cache journal '" + path + "'");
+    }
+  }
+
+  // Truncate to the header, under a new generation.
+  double reset() {
+    double gen = generation() + 1;
+    write_header((uint64_t) gen);
+    if(truncate_file(fd, HEADER_SIZE) != 0) {
+      stop("unable to truncate cache journal '" + path + "'");
+    }
+    return gen;
+  }
+
+  std::string path;
+
+private:
+  void open_file() {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_BINARY, 0644);
+    if(fd < 0) {
+      stop("unable to open cache journal '" + path + "'");
+    }
+    pid = current_pid();
+    locks = 0;
+    std::random_device rd;
+    writer_id = rd() ^ ((uint32_t) pid * 2654435761u) ^
+      (uint32_t) time(NULL) ^ (uint32_t) (uintptr_t) this;
+
+    // Write the header of a new journal.
+    lock(true);
+    if(size() < HEADER_SIZE) {
+      if(truncate_file(fd, 0) != 0) {
+        unlock();
+        stop("unable to initialize cache journal '" + path + "'");
+      }
+      write_header(0);
+    }
+    unlock();
+  }
+
+  // A forked child shares the open file (and its locks) with its parent,
+  // so it must open the journal again.
+  void check_pid() {
+    if(pid != current_pid()) {
+      close(fd);
+      open_file();
+    }
+  }
+
+  void write_header(uint64_t gen) {
+    char header[HEADER_SIZE];
+    memcpy(header, JOURNAL_MAGIC, 8);
+    memcpy(header + 8, &gen, 8);
+    seek_file(fd, 0, SEEK_SET);
+    if(!write_fully(fd, header, HEADER_SIZE)) {
+      stop("unable to write to cache journal '" + path + "'");
+    }
+  }
+
+  int fd;
+  int pid;
+  int locks;
+  uint32_t writer_id;
+};
+
+
+// Keeps the lock on a journal until the end of the scope, if "locked".
+class JournalLock {
+public:
+  JournalLock(CacheJournal* journal, bool exclusive, bool locked) :
+  journal(journal), locked(locked) {
+    if(locked) {
+      journal->lock(exclusive);
+    }
+  }
+
+  ~JournalLock() {
+    if(locked) {
+      journal->unlock();
+    }
+  }
+
+private:
+  CacheJournal* journal;
+  bool locked;
+};
+
+
+static uint32_t record_checksum(const char* buf, size_t len) {
+  return adler32(adler32(0L, Z_NULL, 0), (const Bytef*) buf, len);
+}
+
+
+// [[Rcpp::export]]
+SEXP cache_journal_open(std::string path) {
+  XPtr<CacheJournal> ptr(new CacheJournal(path), true);
+  return ptr;
+}
+
+
+// [[Rcpp::export]]
+void cache_journal_lock(SEXP journal, bool exclusive) {
+  XPtr<CacheJournal> ptr(journal);
+  ptr->lock(exclusive);
+}
+
+
+// [[Rcpp::export]]
+void cache_journal_unlock(SEXP journal) {
+  XPtr<CacheJournal> ptr(journal);
+  ptr->unlock();
+}
+
+
+// [[Rcpp::export]]
+double cache_journal_generation(SEXP journal) {
+  XPtr<CacheJournal> ptr(journal);
+  JournalLock lock(ptr.checked_get(), false, true);
+  return ptr->generation();
+}
+
+
+// Offset of the first record of a journal.
+// [[Rcpp::export]]
+double cache_journal_start() {
+  return HEADER_SIZE;
+}
+
+
+// Append one record of type "magic" per key, in a single write.
+static void append_records(XPtr<CacheJournal>& ptr, uint32_t magic,
+                           CharacterVector& keys,
+                           const std::vector<std::string>& values,
+                           NumericVector& times) {
+  uint32_t writer = ptr->writer();
+  std::string buf;
+  int n = keys.size();
+  for(int i = 0; i < n; ++i) {
+    std::string key = as<std::string>(keys[i]);
+    uint32_t key_len = key.size();
+    uint32_t value_len = values.empty() ? 0 : values[i].size();
+    double time = times[i];
+
+    size_t start = buf.size();
+    buf.append((const char*) &magic, 4);
+    buf.append((const char*) &writer, 4);
+    buf.append((const char*) &key_len, 4);
+    buf.append((const char*) &value_len, 4);
+    buf.append((const char*) &time, 8);
+    buf.append(key);
+    if(!values.empty()) {
+      buf.append(values[i]);
+    }
+    uint32_t checksum = record_checksum(buf.data() + start + 4,
+                                        buf.size() - start - 4);
+    buf.append((const char*) &checksum, 4);
+  }
+
+  JournalLock lock(ptr.checked_get(), true, true);
+  ptr->append(buf);
+}
+
+
+// Append one insert record per cache entry, in a single write.
+// [[Rcpp::export]]
+void cache_journal_append(SEXP journal, CharacterVector& keys, List& values,
+                          NumericVector& inserted) {
+  XPtr<CacheJournal> ptr(journal);
+  int n = keys.size();
+  std::vector<std::string> entries(n);
+  for(int i = 0; i < n; ++i) {
+    entries[i] = serialize_entry(values[i]);
+  }
+  append_records(ptr, RECORD_MAGIC, keys, entries, inserted);
+}
+
+
+// Append one touch record (or eviction record, if "evict") per key, in a
+// single write.
+// [[Rcpp::export]]
+void cache_journal_append_tracker(SEXP journal, CharacterVector& keys,
+                                  NumericVector& times, bool evict) {
+  XPtr<CacheJournal> ptr(journal);
+  append_records(ptr, evict ? EVICT_MAGIC : TOUCH_MAGIC, keys,
+                 std::vector<std::string>(), times);
+}
+
+
+// Read the records appended at or after "offset" by other journal handles
+// (records of this handle are skipped, unless "include_self"). Returns the
+// records (type, key, value, and time of each, in journal order), the
+// offset to read from next time, and the journal generation.
+// If the journal was compacted (the generation differs from "generation"),
+// no records are returned.
+// [[Rcpp::export]]
+List cache_journal_read(SEXP journal, double offset, double generation,
+                        bool include_self) {
+  XPtr<CacheJournal> ptr(journal);
+  uint32_t self = ptr->writer();
+  std::string buf;
+  double gen;
+  {
+    JournalLock lock(ptr.checked_get(), false, true);
+    gen = ptr->generation();
+    if(gen == generation) {
+      ptr->read_from((int64_t) offset, buf);
+    }
+  }
+
+  std::vector<std::string> types;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  std::vector<double> times;
+  size_t pos = 0;
+  size_t end = 0;
+  while(pos + RECORD_OVERHEAD <= buf.size()) {
+    uint32_t magic;
+    uint32_t writer;
+    uint32_t key_len;
+    uint32_t value_len;
+    double time;
+    memcpy(&magic, buf.data() + pos, 4);
+    memcpy(&writer, buf.data() + pos + 4, 4);
+    memcpy(&key_len, buf.data() + pos + 8, 4);
+    memcpy(&value_len, buf.data() + pos + 12, 4);
+    memcpy(&time, buf.data() + pos + 16, 8);
+    size_t len = RECORD_OVERHEAD + (size_t) key_len + value_len;
+
+    bool valid = (magic == RECORD_MAGIC || magic == TOUCH_MAGIC ||
+                  magic == EVICT_MAGIC) && pos + len <= buf.size();
+    if(valid) {
+      uint32_t checksum;
+      memcpy(&checksum, buf.data() + pos + len - 4, 4);
+      valid = checksum == record_checksum(buf.data() + pos + 4, len - 8);
+    }
+    if(!valid) {
+      // Skip to the next record magic.
+      pos += 1;
+      continue;
+    }
+
+    if(include_self || writer != self) {
+      types.push_back(magic == RECORD_MAGIC ? "insert" :
+                        magic == TOUCH_MAGIC ? "touch" : "evict");
+      keys.push_back(buf.substr(pos + 24, key_len));
+      values.push_back(buf.substr(pos + 24 + key_len, value_len));
+      times.push_back(time);
+    }
+    pos += len;
+    end = pos;
+  }
+
+  // A record that is still being written (or was torn) at the end of the
+  // journal is read again next time.
+  int n = keys.size();
+  List value_list(n);
+  for(int i = 0; i < n; ++i) {
+    value_list[i] = unserialize_entry(values[i]);
+  }
+
+  return List::create(
+    Named("types") = wrap(types),
+    Named("keys") = wrap(keys),
+    Named("values") = value_list,
+    Named("times") = wrap(times),
+    Named("offset") = offset + end,
+    Named("generation") = gen
+  );
+}
+
+
+// Truncate the journal and increment its generation. Returns the new
+// generation. Called with the exclusive lock held.
+// [[Rcpp::export]]
+double cache_journal_reset(SEXP journal) {
+  XPtr<CacheJournal> ptr(journal);
+  JournalLock lock(ptr.checked_get(), true, true);
+  return ptr->reset();
+}
+
+
+// Size of the journal, in bytes.
+// [[Rcpp::export]]
+double cache_journal_size(SEXP journal) {
+  XPtr<CacheJournal> ptr(journal);
+  return ptr->size();
+}
@@ -0,0 +1,175 @@
+#include <Rcpp.h>
+#include "baidugeo.h"
+using namespace Rcpp;
+
+
+// Cross-cache seeding: derive entries of one package cache from the entries
+// of the other.
+//   - A forward result (coord_hash_map) places its location string at
+//     result.location, which pre-answers a reverse query at that point.
+//   - A reverse result (addr_hash_map) gives the formatted_address found at
+//     result.location, which pre-answers a forward query of that address.
+// Derived entries are json text objects in the format of the API, holding
+// only the fields that can be derived, and marked with "derived":"forward"
+// or "derived":"reverse" (the kind of result they were derived from).
+// Entries that are themselves derived are never used as seeds.
+
+
+// Parse a successful, non-derived API response, and get its
+// result.location. Returns false if the response can't be used as a seed.
+static bool parse_seed(const char* json, rapidjson::Document& doc,
+                       double& lng, double& lat) {
+  doc.Parse(json);
+  if(doc.HasParseError() || !doc.IsObject() || doc.HasMember("derived")) {
+    return false;
+  }
+  rapidjson::Value::ConstMemberIterator status = doc.FindMember("status");
+  if(status == doc.MemberEnd() || !status->value.IsNumber() ||
+     status->value.GetDouble() != 0) {
+    return false;
+  }
+  rapidjson::Value::ConstMemberIterator result = doc.FindMember("result");
+  if(result == doc.MemberEnd() || !result->value.IsObject()) {
+    return false;
+  }
+  rapidjson::Value::ConstMemberIterator location =
+    result->value.FindMember("location");
+  if(location == result->value.MemberEnd() || !location->value.IsObject()) {
+    return false;
+  }
+  rapidjson::Value::ConstMemberIterator lng_it =
+    location->value.FindMember("lng");
+  rapidjson::Value::ConstMemberIterator lat_it =
+    location->value.FindMember("lat");
+  if(lng_it == location->value.MemberEnd() || !lng_it->value.IsNumber() ||
+     lat_it == location->value.MemberEnd() || !lat_it->value.IsNumber()) {
+    return false;
+  }
+  lng = lng_it->value.GetDouble();
+  lat = lat_it->value.GetDouble();
+  return true;
+}
+
+
+// Derive reverse query entries from the coord_hash_map entries of "keys".
+// Returns the lat/lon of each derived entry (to build its addr_hash_map
+// key) and its json.
+// [[Rcpp::export]]
+List seed_from_coords(Environment& coord_hash_map, CharacterVector& keys) {
+  int n = keys.size();
+  std::vector<double> lat;
+  std::vector<double> lng;
+  std::vector<std::string> json;
+  rapidjson::Document doc;
+
+  for(int i = 0; i < n; ++i) {
+    SEXP value = coord_hash_map.get(as<std::string>(keys[i]));
+    if(TYPEOF(value) != STRSXP || Rf_length(value) != 2 ||
+       STRING_ELT(value, 0) == NA_STRING ||
+       STRING_ELT(value, 1) == NA_STRING) {
+      continue;
+    }
+    double x;
+    double y;
+    if(!parse_seed(CHAR(STRING_ELT(value, 1)), doc, x, y)) {
+      continue;
+    }
+
+    std::string out = "{\"status\":0,\"result\":{\"location\":{\"lng\":";
+    append_number(x, out);
+    out += ",\"lat\":";
+    append_number(y, out);
+    out += "},\"formatted_address\":";
+    append_json_string(Rf_translateCharUTF8(STRING_ELT(value, 0)), out);
+    out += ",\"addressComponent\":{}},\"derived\":\"forward\"}";
+
+    lat.push_back(y);
+    lng.push_back(x);
+    json.push_back(out);
+  }
+
+  int m = json.size();
+  CharacterVector json_out(m);
+  for(int i = 0; i < m; ++i) {
+    json_out[i] = String(json[i], CE_UTF8);
+  }
+
+  return List::create(
+    Named("lat") = wrap(lat),
+    Named("lon") = wrap(lng),
+    Named("json") = json_out
+  );
+}
+
+
+// Derive forward query entries from the addr_hash_map entries of "keys".
+// Returns the formatted_address of each derived entry (the location string
+// to key it by in coord_hash_map) and its json.
+// [[Rcpp::export]]
+List seed_from_addrs(Environment& addr_hash_map, CharacterVector& keys) {
+  int n = keys.size();
+  std::vector<std::string> location;
+  std::vector<std::string> json;
+  rapidjson::Document doc;
+
+  for(int i = 0; i < n; ++i) {
+    SEXP value = addr_hash_map.get(as<std::string>(keys[i]));
+    if(TYPEOF(value) != STRSXP || Rf_length(value) != 1 ||
+       STRING_ELT(value, 0) == NA_STRING) {
+      continue;
+    }
+    double x;
+    double y;
+    if(!parse_seed(CHAR(STRING_ELT(value, 0)), doc, x, y)) {
+      continue;
+    }
+    rapidjson::Value::ConstMemberIterator address =
+      doc["result"].FindMember("formatted_address");
+    if(address == doc["result"].MemberEnd() || !address->value.IsString() ||
+       address->value.GetStringLength() == 0) {
+      continue;
+    }
+
+    std::string out = "{\"status\":0,\"result\":{\"location\":{\"lng\":";
+    append_number(x, out);
+    out += ",\"lat\":";
+    append_number(y, out);
+    out += "}},\"derived\":\"reverse\"}";
+
+    location.push_back(address->value.GetString());
+    json.push_back(out);
+  }
+
+  int m = json.size();
+  CharacterVector location_out(m);
+  CharacterVector json_out(m);
+  for(int i = 0; i < m; ++i) {
+    location_out[i] = String(location[i], CE_UTF8);
+    json_out[i] = String(json[i], CE_UTF8);
+  }
+
+  return List::create(
+    Named("location") = location_out,
+    Named("json") = json_out
+  );
+}
+
+
+// True for each json string that is a derived entry. Used to let a better
+// answer (e.g. the admin grid) take precedence over derived cache hits.
+// [[Rcpp::export]]
+LogicalVector is_derived_entry(CharacterVector& json) {
+  int n = json.size();
+  LogicalVector out(n);
+  rapidjson::Document doc;
+  for(int i = 0; i < n; ++i) {
+    if(CharacterVector::is_na(json[i])) {
+      out[i] = false;
+      continue;
+    }
+    doc.Parse(CHAR(STRING_ELT(json, i)));
+    out[i] = !doc.HasParseError() && doc.IsObject() &&
+      doc.HasMember("derived");
+  }
+  return out;
+}
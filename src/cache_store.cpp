@@ -0,0 +1,240 @@
+#include <Rcpp.h>
+#include <lzma.h>
+#include <algorithm>
+#include "baidugeo.h"
+using namespace Rcpp;
+
+
+// On-disk form of the package caches. Cache entries (char vectors) are
+// stored in blocks of up to "cache_block_size" entries. The payload of a
+// block holds, for each entry, the key size and the entry size (32 bits
+// each, little endian), then the key, then the serialized entry. Each
+// block is compressed with raw LZMA2. Keys sit next to their entries, so
+// the coordinates in a key are matched again in its entry, and a block is
+// long enough to learn the JSON shared by its entries. A block is only
+// compressed again when one of its entries has changed (see
+// build_cache_store()).
+//
+// When a cache is loaded, all blocks are decompressed, and every entry is
+// bound in the cache environment.
+//
+// Each element of an entry is serialized as one encoding byte ('U' for
+// UTF-8, 'L' for latin1, 'B' for bytes, 'N' for native, 'X' for NA)
+// followed by the string bytes, and elements are separated by NUL bytes (R
+// strings cannot contain NUL).
+
+
+// Serialize a char vector cache entry.
+std::string serialize_entry(SEXP value) {
+  std::string out;
+  int n = Rf_length(value);
+  for(int i = 0; i < n; ++i) {
+    SEXP str = STRING_ELT(value, i);
+    if(i > 0) {
+      out += '\0';
+    }
+    if(str == NA_STRING) {
+      out += 'X';
+      continue;
+    } else if(Rf_getCharCE(str) == CE_UTF8) {
+      out += 'U';
+    } else if(Rf_getCharCE(str) == CE_LATIN1) {
+      out += 'L';
+    } else if(Rf_getCharCE(str) == CE_BYTES) {
+      out += 'B';
+    } else {
+      out += 'N';
+    }
+    out += CHAR(str);
+  }
+  return out;
+}
+
+
+CharacterVector unserialize_entry(const std::string& entry) {
+  if(entry.empty()) {
+    return CharacterVector(0);
+  }
+  std::vector<std::string> elems;
+  size_t start = 0;
+  size_t pos;
+  while((pos = entry.find('\0', start)) != std::string::npos) {
+    elems.push_back(entry.substr(start, pos - start));
+    start = pos + 1;
+  }
+  elems.push_back(entry.substr(start));
+
+  CharacterVector out(elems.size());
+  for(size_t i = 0; i < elems.size(); ++i) {
+    cetype_t enc = CE_NATIVE;
+    if(elems[i][0] == 'X') {
+      out[i] = NA_STRING;
+      continue;
+    } else if(elems[i][0] == 'U') {
+      enc = CE_UTF8;
+    } else if(elems[i][0] == 'L') {
+      enc = CE_LATIN1;
+    } else if(elems[i][0] == 'B') {
+      enc = CE_BYTES;
+    }
+    out[i] = Rf_mkCharLenCE(elems[i].data() + 1, elems[i].size() - 1, enc);
+  }
+  return out;
+}
+
+
+// Append a 32-bit size to "out", little endian.
+static void put_size(std::string& out, size_t size) {
+  for(int i = 0; i < 4; ++i) {
+    out += (char) ((size >> (8 * i)) & 0xff);
+  }
+}
+
+
+// Read a 32-bit size at "pos" of "in", little endian.
+static size_t get_size(const std::string& in, size_t pos) {
+  size_t size = 0;
+  for(int i = 0; i < 4; ++i) {
+    size |= (size_t) (unsigned char) in[pos + i] << (8 * i);
+  }
+  return size;
+}
+
+
+// LZMA2 options for a block of "size" bytes. The match window (the LZMA2
+// dictionary) is cut to the size of the block, as matches never reach
+// further back, which keeps the memory and setup time of the coder small.
+static void block_filters(lzma_options_lzma& opts, lzma_filter* filters,
+                          size_t size) {
+  if(lzma_lzma_preset(&opts, 6)) {
+    stop("unable to initialize liblzma");
+  }
+  opts.dict_size = std::max((size_t) LZMA_DICT_SIZE_MIN,
+                            std::min((size_t) opts.dict_size, size));
+  filters[0].id = LZMA_FILTER_LZMA2;
+  filters[0].options = &opts;
+  filters[1].id = LZMA_VLI_UNKNOWN;
+  filters[1].options = NULL;
+}
+
+
+// Compress the payload of a block.
+static RawVector compress_block(const std::string& payload) {
+  lzma_options_lzma opts;
+  lzma_filter filters[2];
+  block_filters(opts, filters, payload.size());
+  std::vector<unsigned char> out(payload.size() + payload.size() / 2 + 128);
+  size_t out_pos = 0;
+  if(lzma_raw_buffer_encode(filters, NULL,
+                            (const uint8_t*) payload.data(), payload.size(),
+                            &out[0], &out_pos, out.size()) != LZMA_OK) {
+    stop("unable to compress cache block");
+  }
+  return RawVector(out.begin(), out.begin() + out_pos);
+}
+
+
+// Decompress a block into "payload", which must be "size" bytes.
+static void decompress_block(const RawVector& block, size_t size,
+                             std::string& payload) {
+  lzma_options_lzma opts;
+  lzma_filter filters[2];
+  block_filters(opts, filters, size);
+  payload.resize(size);
+  size_t in_pos = 0;
+  size_t out_pos = 0;
+  if(size == 0) {
+    return;
+  }
+  if(lzma_raw_buffer_decode(filters, NULL, block.begin(), &in_pos,
+                            block.size(), (uint8_t*) &payload[0], &out_pos,
+                            size) != LZMA_OK || out_pos != size) {
+    stop("corrupt cache block");
+  }
+}
+
+
+// Build the on-disk form of cache entries "keys" of a cache environment:
+// the entries are cut into blocks of "block_size" entries, in the order of
+// "keys", and each block is compressed. Returns the compressed blocks, the
+// payload size of each block, and the keys of each block.
+// [[Rcpp::export]]
+List cache_store_build(Environment& hash_map, CharacterVector& keys,
+                       int block_size) {
+  int n = keys.size();
+  int n_blocks = (n + block_size - 1) / block_size;
+  List blocks(n_blocks);
+  NumericVector sizes(n_blocks);
+  List block_keys(n_blocks);
+
+  for(int b = 0; b < n_blocks; ++b) {
+    int start = b * block_size;
+    int end = std::min(n, start + block_size);
+    std::string payload;
+    CharacterVector keys_in_block(end - start);
+    for(int i = start; i < end; ++i) {
+      keys_in_block[i - start] = keys[i];
+      SEXP value = Rf_findVarInFrame(hash_map,
+                                     Rf_install(CHAR(STRING_ELT(keys, i))));
+      if(TYPEOF(value) != STRSXP) {
+        stop("cache key not found: " + as<std::string>(keys[i]));
+      }
+      std::string entry = serialize_entry(value);
+      put_size(payload, LENGTH(STRING_ELT(keys, i)));
+      put_size(payload, entry.size());
+      payload += CHAR(STRING_ELT(keys, i));
+      payload += entry;
+    }
+    blocks[b] = compress_block(payload);
+    sizes[b] = payload.size();
+    block_keys[b] = keys_in_block;
+  }
+
+  return List::create(
+    Named("blocks") = blocks,
+    Named("sizes") = sizes,
+    Named("keys") = block_keys
+  );
+}
+
+
+// Decompress every block of a cache store, and bind its entries in
+// "hash_map". Returns the keys of each block.
+// [[Rcpp::export]]
+List cache_store_restore(Environment& hash_map, List& blocks,
+                         NumericVector& sizes) {
+  int n_blocks = blocks.size();
+  if(sizes.size() != n_blocks) {
+    stop("corrupt cache store");
+  }
+  List block_keys(n_blocks);
+  std::string payload;
+
+  for(int b = 0; b < n_blocks; ++b) {
+    RawVector block = blocks[b];
+    decompress_block(block, (size_t) sizes[b], payload);
+    std::vector<std::string> keys;
+    size_t pos = 0;
+    while(pos < payload.size()) {
+      if(payload.size() - pos < 8) {
+        stop("corrupt cache block");
+      }
+      size_t key_size = get_size(payload, pos);
+      size_t entry_size = get_size(payload, pos + 4);
+      pos += 8;
+      if(payload.size() - pos < key_size + entry_size) {
+        stop("corrupt cache block");
+      }
+      keys.push_back(payload.substr(pos, key_size));
+      SEXP value = PROTECT(unserialize_entry(
+        payload.substr(pos + key_size, entry_size)
+      ));
+      Rf_defineVar(Rf_install(keys.back().c_str()), value, hash_map);
+      UNPROTECT(1);
+      pos += key_size + entry_size;
+    }
+    block_keys[b] = wrap(keys);
+  }
+
+  return block_keys;
+}
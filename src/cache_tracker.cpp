@@ -0,0 +1,282 @@
+#include <Rcpp.h>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include "baidugeo.h"
+using namespace Rcpp;
+
+
+// Tracks insert time and last access time of every key of a package cache
+// (coord_hash_map or addr_hash_map), and decides which keys to evict.
+//
+// Three intrusive lists are kept over the keys of "entries":
+//   - "lru", ordered by last access, least recently used key at the front.
+//   - "age", ordered by insert time, oldest key at the front.
+//   - "pending", the keys inserted since they were last taken as seeds (see
+//     bmap_seed_caches()), in insert order.
+// Keys are always inserted at the back of "age". A key inserted with a time
+// older than the newest key (an entry replayed from the cache journal of
+// another process) takes the time of the newest key instead, so "age" stays
+// ordered. Insert, touch, and remove are all O(1), and eviction only ever
+// inspects the fronts of the two lists, so the cost of eviction is O(1) per
+// key evicted.
+class CacheTracker {
+public:
+  struct Entry {
+    double inserted;
+    double accessed;
+    std::list<const std::string*>::iterator lru_it;
+    std::list<const std::string*>::iterator age_it;
+    std::list<const std::string*>::iterator pending_it;
+    bool is_pending;
+  };
+
+  void insert(const std::string& key, double now, bool is_pending = true) {
+    std::unordered_map<std::string, Entry>::iterator it = entries.find(key);
+    if(it == entries.end()) {
+      it = entries.emplace(key, Entry()).first;
+      it->second.lru_it = lru.insert(lru.end(), &it->first);
+      it->second.is_pending = false;
+    } else {
+      // Re-inserting a key refreshes it.
+      lru.splice(lru.end(), lru, it->second.lru_it);
+      age.erase(it->second.age_it);
+    }
+    if(!age.empty()) {
+      now = std::max(now, entries[*age.back()].inserted);
+    }
+    it->second.age_it = age.insert(age.end(), &it->first);
+    it->second.inserted = now;
+    it->second.accessed = now;
+    if(is_pending && !it->second.is_pending) {
+      it->second.pending_it = pending.insert(pending.end(), &it->first);
+      it->second.is_pending = true;
+    }
+  }
+
+  void touch(const std::string& key, double now) {
+    std::unordered_map<std::string, Entry>::iterator it = entries.find(key);
+    if(it == entries.end()) {
+      return;
+    }
+    it->second.accessed = now;
+    lru.splice(lru.end(), lru, it->second.lru_it);
+  }
+
+  void remove(const std::string& key) {
+    std::unordered_map<std::string, Entry>::iterator it = entries.find(key);
+    if(it == entries.end()) {
+      return;
+    }
+    lru.erase(it->second.lru_it);
+    age.erase(it->second.age_it);
+    if(it->second.is_pending) {
+      pending.erase(it->second.pending_it);
+    }
+    entries.erase(it);
+  }
+
+  bool is_expired(const std::string& key, double now, double max_age) {
+    std::unordered_map<std::string, Entry>::iterator it = entries.find(key);
+    if(it == entries.end()) {
+      return false;
+    }
+    return now - it->second.inserted > max_age;
+  }
+
+  // Remove expired keys, then remove least recently used keys until the
+  // number of keys is at most "max_entries". Evicted keys are appended to
+  // "evicted".
+  void evict(double max_entries, double max_age, double now,
+             std::vector<std::string>& evicted) {
+    while(!age.empty() && now - entries[*age.front()].inserted > max_age) {
+      evicted.push_back(*age.front());
+      remove(evicted.back());
+    }
+    while(!lru.empty() && entries.size() > max_entries) {
+      evicted.push_back(*lru.front());
+      remove(evicted.back());
+    }
+  }
+
+  // Move the pending keys to "out", oldest first.
+  void take_pending(std::vector<std::string>& out) {
+    std::list<const std::string*>::iterator it;
+    for(it = pending.begin(); it != pending.end(); ++it) {
+      out.push_back(**it);
+      entries[**it].is_pending = false;
+    }
+    pending.clear();
+  }
+
+  std::unordered_map<std::string, Entry> entries;
+  std::list<const std::string*> lru;
+  std::list<const std::string*> age;
+  std::list<const std::string*> pending;
+};
+
+
+// [[Rcpp::export]]
+SEXP cache_tracker_new() {
+  XPtr<CacheTracker> ptr(new CacheTracker(), true);
+  return ptr;
+}
+
+
+// Rebuild tracker state from the "keys", "inserted", "accessed", and
+// "pending" vectors that were saved along with the cache.
+// [[Rcpp::export]]
+void cache_tracker_load(SEXP tracker,
+                        CharacterVector& keys,
+                        NumericVector& inserted,
+                        NumericVector& accessed,
+                        LogicalVector& pending) {
+  XPtr<CacheTracker> ptr(tracker);
+  int n = keys.size();
+
+  // Insert keys by ascending insert time, so the "age" list is ordered.
+  std::vector<int> idx(n);
+  for(int i = 0; i < n; ++i) {
+    idx[i] = i;
+  }
+  std::stable_sort(idx.begin(), idx.end(), [&](int a, int b) {
+    return inserted[a] < inserted[b];
+  });
+  for(int i = 0; i < n; ++i) {
+    ptr->insert(as<std::string>(keys[idx[i]]), inserted[idx[i]],
+                pending[idx[i]] == TRUE);
+  }
+
+  // Then touch keys by ascending access time, so the "lru" list is ordered.
+  std::stable_sort(idx.begin(), idx.end(), [&](int a, int b) {
+    return accessed[a] < accessed[b];
+  });
+  for(int i = 0; i < n; ++i) {
+    ptr->touch(as<std::string>(keys[idx[i]]), accessed[idx[i]]);
+  }
+}
+
+
+// [[Rcpp::export]]
+void cache_tracker_insert(SEXP tracker, std::string key, double now) {
+  XPtr<CacheTracker> ptr(tracker);
+  ptr->insert(key, now);
+}
+
+
+// [[Rcpp::export]]
+void cache_tracker_touch(SEXP tracker, std::string key, double now) {
+  XPtr<CacheTracker> ptr(tracker);
+  ptr->touch(key, now);
+}
+
+
+// [[Rcpp::export]]
+void cache_tracker_remove(SEXP tracker, CharacterVector& keys) {
+  XPtr<CacheTracker> ptr(tracker);
+  int n = keys.size();
+  for(int i = 0; i < n; ++i) {
+    ptr->remove(as<std::string>(keys[i]));
+  }
+}
+
+
+// Remove the keys that were inserted at or before "time", and return them.
+// Used to replay evictions from the cache journal of another process, which
+// must not remove a key that was inserted again after it was evicted.
+// [[Rcpp::export]]
+CharacterVector cache_tracker_remove_before(SEXP tracker,
+                                            CharacterVector& keys,
+                                            double time) {
+  XPtr<CacheTracker> ptr(tracker);
+  std::vector<std::string> removed;
+  int n = keys.size();
+  for(int i = 0; i < n; ++i) {
+    std::string key = as<std::string>(keys[i]);
+    std::unordered_map<std::string, CacheTracker::Entry>::iterator it =
+      ptr->entries.find(key);
+    if(it != ptr->entries.end() && it->second.inserted <= time) {
+      ptr->remove(key);
+      removed.push_back(key);
+    }
+  }
+  return wrap(removed);
+}
+
+
+// [[Rcpp::export]]
+bool cache_tracker_is_expired(SEXP tracker, std::string key, double now,
+                              double max_age) {
+  XPtr<CacheTracker> ptr(tracker);
+  return ptr->is_expired(key, now, max_age);
+}
+
+
+// Returns the keys that were evicted, which the caller must then remove
+// from the cache environment.
+// [[Rcpp::export]]
+CharacterVector cache_tracker_evict(SEXP tracker, double max_entries,
+                                    double max_age, double now) {
+  XPtr<CacheTracker> ptr(tracker);
+  std::vector<std::string> evicted;
+  ptr->evict(max_entries, max_age, now, evicted);
+  return wrap(evicted);
+}
+
+
+// Returns the keys inserted since the previous call, oldest first, and
+// clears them. Used to find the cache entries that have not been seeds yet.
+// [[Rcpp::export]]
+CharacterVector cache_tracker_take_pending(SEXP tracker) {
+  XPtr<CacheTracker> ptr(tracker);
+  std::vector<std::string> out;
+  ptr->take_pending(out);
+  return wrap(out);
+}
+
+
+// [[Rcpp::export]]
+int cache_tracker_size(SEXP tracker) {
+  XPtr<CacheTracker> ptr(tracker);
+  return ptr->entries.size();
+}
+
+
+// Return tracker state as a data.frame, in least recently used order. This
+// is the object that gets saved along with the cache.
+// [[Rcpp::export]]
+List cache_tracker_meta(SEXP tracker) {
+  XPtr<CacheTracker> ptr(tracker);
+  int n = ptr->entries.size();
+  CharacterVector keys(n);
+  NumericVector inserted(n);
+  NumericVector accessed(n);
+  LogicalVector pending(n);
+
+  int i = 0;
+  std::list<const std::string*>::iterator it;
+  for(it = ptr->lru.begin(); it != ptr->lru.end(); ++it) {
+    const CacheTracker::Entry& entry = ptr->entries[**it];
+    keys[i] = **it;
+    inserted[i] = entry.inserted;
+    accessed[i] = entry.accessed;
+    pending[i] = entry.is_pending;
+    ++i;
+  }
+
+  List out = List::create(
+    Named("key") = keys,
+    Named("inserted") = inserted,
+    Named("accessed") = accessed,
+    Named("pending") = pending
+  );
+
+  out.attr("class") = "data.frame";
+  if(n > 0) {
+    out.attr("row.names") = seq(1, n);
+  } else {
+    out.attr("row.names") = 0;
+  }
+
+  return out;
+}
@@ -63,6 +63,14 @@ void from_json_coords(std::string& json) {
   } else {
     coord_vars::level = NA_STRING;
   }
+  
+  // derived (cache entries derived from other results, see cache_seed.cpp).
+  if(global_vars::doc.HasMember("derived") && 
+     global_vars::doc["derived"].IsString()) {
+    global_vars::derived = global_vars::doc["derived"].GetString();
+  } else {
+    global_vars::derived = NA_STRING;
+  }
 }
 
 
@@ -77,6 +85,7 @@ List from_json_coords_vector(CharacterVector location,
   IntegerVector confidence(json_len);
   NumericVector comprehension(json_len);
   CharacterVector level(json_len);
+  CharacterVector derived(json_len);
   
   for(int i = 0; i < json_len; ++i) {
     // Parse json, assign values from the parsed json.
@@ -88,6 +97,7 @@ List from_json_coords_vector(CharacterVector location,
     confidence[i] = coord_vars::confidence[0];
     comprehension[i] = coord_vars::comprehension[0];
     level[i] = coord_vars::level;
+    derived[i] = global_vars::derived;
   }
   
   // Create List output that has the necessary attributes to make it a
@@ -100,7 +110,8 @@ List from_json_coords_vector(CharacterVector location,
     Named("precise") = precise,
     Named("confidence") = confidence,
     Named("comprehension") = comprehension,
-    Named("level") = level
+    Named("level") = level,
+    Named("derived") = derived
   );
   
   out.attr("class") = "data.frame";
@@ -122,6 +133,7 @@ List get_coords_pkg_data(Environment& coord_hash_map,
   IntegerVector confidence(cache_len);
   NumericVector comprehension(cache_len);
   CharacterVector level(cache_len);
+  CharacterVector derived(cache_len);
   
   CharacterVector curr_res;
   String curr_key;
@@ -145,6 +157,7 @@ List get_coords_pkg_data(Environment& coord_hash_map,
     confidence[i] = coord_vars::confidence[0];
     comprehension[i] = coord_vars::comprehension[0];
     level[i] = coord_vars::level;
+    derived[i] = global_vars::derived;
   }
   
   // Create List output that has the necessary attributes to make it a
@@ -157,7 +170,8 @@ List get_coords_pkg_data(Environment& coord_hash_map,
     Named("precise") = precise,
     Named("confidence") = confidence,
     Named("comprehension") = comprehension,
-    Named("level") = level
+    Named("level") = level,
+    Named("derived") = derived
   );
   
   out.attr("class") = "data.frame";
@@ -0,0 +1,342 @@
+#include <Rcpp.h>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+#include "baidugeo.h"
+using namespace Rcpp;
+
+
+// Character bigram index over the location strings of coord_hash_map, used
+// to find the most similar cached location for an input location.
+//
+// Similarity is the Dice coefficient of the two sets of character bigrams,
+// 2 * |A n B| / (|A| + |B|). Queries use length and prefix filtering: a
+// cached string can only reach the threshold if its bigram count is within
+// known bounds of the query's, and if it shares at least one of the query's
+// rarest bigrams. Only the postings of those rare bigrams are scanned, and
+// the few candidates found are then scored exactly, which keeps queries
+// fast even over millions of cached strings.
+class FuzzyIndex {
+public:
+  FuzzyIndex(std::vector<std::string> suffixes)
+    : suffixes(suffixes), n_dead(0) {}
+
+  void add(const std::string& key, const std::string& location) {
+    std::unordered_map<std::string, int>::iterator it = doc_ids.find(key);
+    if(it != doc_ids.end()) {
+      remove(key);
+    }
+
+    std::vector<uint64_t> doc = grams(location);
+    if(doc.empty()) {
+      return;
+    }
+
+    int id = keys.size();
+    keys.push_back(key);
+    docs.push_back(doc);
+    live.push_back(true);
+    doc_ids[key] = id;
+    for(size_t i = 0; i < doc.size(); ++i) {
+      postings[doc[i]].push_back(id);
+    }
+  }
+
+  // Removed documents stay in the postings lists, and are skipped at query
+  // time, until they outnumber the live documents. The index is then
+  // compacted, which keeps the cost of removal amortized O(1).
+  void remove(const std::string& key) {
+    std::unordered_map<std::string, int>::iterator it = doc_ids.find(key);
+    if(it == doc_ids.end()) {
+      return;
+    }
+    live[it->second] = false;
+    std::vector<uint64_t>().swap(docs[it->second]);
+    std::string().swap(keys[it->second]);
+    doc_ids.erase(it);
+    ++n_dead;
+    if(n_dead > 1024 && n_dead > doc_ids.size()) {
+      compact();
+    }
+  }
+
+  // Returns the id of the most similar live document with similarity of at
+  // least "threshold", or -1.
+  int query(const std::string& location, double threshold, double& score) {
+    std::vector<uint64_t> query_grams = grams(location);
+    int n = query_grams.size();
+    score = 0;
+    if(n == 0) {
+      return -1;
+    }
+
+    // Bounds on the bigram count of a document that can reach the
+    // threshold, and the min overlap with the smallest such document.
+    int min_len = std::ceil(threshold * n / (2.0 - threshold) - 1e-9);
+    int max_len = std::floor((2.0 - threshold) * n / threshold + 1e-9);
+    int min_overlap = std::ceil(threshold * (n + min_len) / 2.0 - 1e-9);
+    int prefix_len = std::max(1, n - min_overlap + 1);
+
+    // Rarest bigrams first.
+    std::vector<std::pair<size_t, uint64_t> > by_freq;
+    for(int i = 0; i < n; ++i) {
+      std::unordered_map<uint64_t, std::vector<int> >::iterator p;
+      p = postings.find(query_grams[i]);
+      by_freq.push_back(std::make_pair(
+        p == postings.end() ? 0 : p->second.size(), query_grams[i]
+      ));
+    }
+    std::sort(by_freq.begin(), by_freq.end());
+
+    std::vector<int> candidates;
+    for(int i = 0; i < prefix_len && i < n; ++i) {
+      std::unordered_map<uint64_t, std::vector<int> >::iterator p;
+      p = postings.find(by_freq[i].second);
+      if(p == postings.end()) {
+        continue;
+      }
+      const std::vector<int>& ids = p->second;
+      for(size_t j = 0; j < ids.size(); ++j) {
+        int len = docs[ids[j]].size();
+        if(live[ids[j]] && len >= min_len && len <= max_len) {
+          candidates.push_back(ids[j]);
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    int best = -1;
+    for(size_t i = 0; i < candidates.size(); ++i) {
+      const std::vector<uint64_t>& doc = docs[candidates[i]];
+      int overlap = intersect_size(query_grams, doc);
+      double curr_score = 2.0 * overlap / (n + doc.size());
+      if(curr_score >= threshold && curr_score > score) {
+        score = curr_score;
+        best = candidates[i];
+      }
+    }
+
+    return best;
+  }
+
+  int size() {
+    return doc_ids.size();
+  }
+
+  // Number of document slots, live or dead.
+  int capacity() {
+    return keys.size();
+  }
+
+  // Drop the dead documents, renumber the live ones, and rebuild the
+  // postings lists.
+  void compact() {
+    std::vector<int> new_ids(keys.size(), -1);
+    int n = 0;
+    for(size_t i = 0; i < keys.size(); ++i) {
+      if(!live[i]) {
+        continue;
+      }
+      new_ids[i] = n;
+      if((int) i != n) {
+        keys[n].swap(keys[i]);
+        docs[n].swap(docs[i]);
+      }
+      doc_ids[keys[n]] = n;
+      ++n;
+    }
+    keys.resize(n);
+    docs.resize(n);
+    live.assign(n, true);
+    n_dead = 0;
+
+    std::unordered_map<uint64_t, std::vector<int> >::iterator p;
+    for(p = postings.begin(); p != postings.end(); ) {
+      std::vector<int>& ids = p->second;
+      size_t m = 0;
+      for(size_t j = 0; j < ids.size(); ++j) {
+        if(new_ids[ids[j]] >= 0) {
+          ids[m++] = new_ids[ids[j]];
+        }
+      }
+      if(m == 0) {
+        p = postings.erase(p);
+      } else {
+        ids.resize(m);
+        std::vector<int>(ids).swap(ids);
+        ++p;
+      }
+    }
+  }
+
+  std::vector<std::string> keys;
+
+private:
+  // Sorted, unique character bigrams of a location string, after
+  // normalization and removal of common company/branch suffixes. Strings
+  // of a single character are represented by a single unigram.
+  std::vector<uint64_t> grams(const std::string& location) {
+    std::string str = normalize_location(location, true, true, true, true);
+    bool stripped = true;
+    while(stripped) {
+      stripped = false;
+      for(size_t i = 0; i < suffixes.size(); ++i) {
+        const std::string& suffix = suffixes[i];
+        if(str.size() > suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0) {
+          str.erase(str.size() - suffix.size());
+          stripped = true;
+        }
+      }
+    }
+
+    // Split into UTF-8 characters.
+    std::vector<uint64_t> chars;
+    size_t pos = 0;
+    while(pos < str.size()) {
+      size_t len = 1;
+      unsigned char c = str[pos];
+      if((c & 0xE0) == 0xC0) {
+        len = 2;
+      } else if((c & 0xF0) == 0xE0) {
+        len = 3;
+      } else if((c & 0xF8) == 0xF0) {
+        len = 4;
+      }
+      uint64_t ch = 0;
+      for(size_t i = 0; i < len && pos + i < str.size(); ++i) {
+        ch = (ch << 8) | (unsigned char) str[pos + i];
+      }
+      chars.push_back(ch);
+      pos += len;
+    }
+
+    std::vector<uint64_t> out;
+    if(chars.size() == 1) {
+      out.push_back(chars[0]);
+    }
+    for(size_t i = 1; i < chars.size(); ++i) {
+      out.push_back((chars[i - 1] << 32) | chars[i]);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+  }
+
+  static int intersect_size(const std::vector<uint64_t>& a,
+                            const std::vector<uint64_t>& b) {
+    int out = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while(i < a.size() && j < b.size()) {
+      if(a[i] < b[j]) {
+        ++i;
+      } else if(b[j] < a[i]) {
+        ++j;
+      } else {
+        ++out;
+        ++i;
+        ++j;
+      }
+    }
+    return out;
+  }
+
+  std::vector<std::string> suffixes;
+  std::vector<std::vector<uint64_t> > docs;
+  std::vector<bool> live;
+  std::unordered_map<std::string, int> doc_ids;
+  std::unordered_map<uint64_t, std::vector<int> > postings;
+  size_t n_dead;
+};
+
+
+// [[Rcpp::export]]
+SEXP fuzzy_index_new(CharacterVector& suffixes) {
+  std::vector<std::string> suffix_vect;
+  for(int i = 0; i < suffixes.size(); ++i) {
+    suffix_vect.push_back(Rf_translateCharUTF8(STRING_ELT(suffixes, i)));
+  }
+  XPtr<FuzzyIndex> ptr(new FuzzyIndex(suffix_vect), true);
+  return ptr;
+}
+
+
+// [[Rcpp::export]]
+void fuzzy_index_add(SEXP index, CharacterVector& keys,
+                     CharacterVector& location) {
+  XPtr<FuzzyIndex> ptr(index);
+  int n = keys.size();
+  for(int i = 0; i < n; ++i) {
+    if(CharacterVector::is_na(location[i])) {
+      continue;
+    }
+    ptr->add(as<std::string>(keys[i]),
+             Rf_translateCharUTF8(STRING_ELT(location, i)));
+  }
+}
+
+
+// [[Rcpp::export]]
+void fuzzy_index_remove(SEXP index, CharacterVector& keys) {
+  XPtr<FuzzyIndex> ptr(index);
+  int n = keys.size();
+  for(int i = 0; i < n; ++i) {
+    ptr->remove(as<std::string>(keys[i]));
+  }
+}
+
+
+// Returns the coord_hash_map key of the best match of each input location,
+// along with its similarity score. Locations without a match above the
+// threshold get an NA key.
+// [[Rcpp::export]]
+List fuzzy_index_query(SEXP index, CharacterVector& location,
+                       double threshold) {
+  XPtr<FuzzyIndex> ptr(index);
+  int n = location.size();
+  CharacterVector key(n);
+  NumericVector score(n);
+  double curr_score;
+
+  for(int i = 0; i < n; ++i) {
+    if(CharacterVector::is_na(location[i])) {
+      key[i] = NA_STRING;
+      score[i] = NA_REAL;
+      continue;
+    }
+    int best = ptr->query(Rf_translateCharUTF8(STRING_ELT(location, i)),
+                          threshold, curr_score);
+    if(best < 0) {
+      key[i] = NA_STRING;
+      score[i] = NA_REAL;
+    } else {
+      key[i] = ptr->keys[best];
+      score[i] = curr_score;
+    }
+  }
+
+  return List::create(
+    Named("key") = key,
+    Named("score") = score
+  );
+}
+
+
+// [[Rcpp::export]]
+int fuzzy_index_size(SEXP index) {
+  XPtr<FuzzyIndex> ptr(index);
+  return ptr->size();
+}
+
+
+// Number of document slots of the index, including removed documents that
+// have not been compacted away yet.
+// [[Rcpp::export]]
+int fuzzy_index_capacity(SEXP index) {
+  XPtr<FuzzyIndex> ptr(index);
+  return ptr->capacity();
+}
@@ -9,6 +9,7 @@ namespace global_vars {
   NumericVector status;
   NumericVector lng;
   NumericVector lat;
+  String derived;
 }
 
 // Variables used by the coords functions.
@@ -0,0 +1,201 @@
+#include <Rcpp.h>
+#include "baidugeo.h"
+using namespace Rcpp;
+
+
+// Invalid UTF-8 byte, copied to the output unchanged.
+static const unsigned int INVALID_CODE_POINT = 0xFFFFFFFF;
+
+
+// Decode the UTF-8 code point starting at str[pos], and advance pos past
+// it. For invalid or truncated sequences, advance pos by a single byte and
+// return INVALID_CODE_POINT.
+static unsigned int next_code_point(const std::string& str, size_t& pos) {
+  unsigned char c = str[pos];
+  int len;
+  unsigned int cp;
+  if(c < 0x80) {
+    pos += 1;
+    return c;
+  } else if((c & 0xE0) == 0xC0) {
+    len = 2;
+    cp = c & 0x1F;
+  } else if((c & 0xF0) == 0xE0) {
+    len = 3;
+    cp = c & 0x0F;
+  } else if((c & 0xF8) == 0xF0) {
+    len = 4;
+    cp = c & 0x07;
+  } else {
+    pos += 1;
+    return INVALID_CODE_POINT;
+  }
+
+  if(pos + len > str.size()) {
+    pos += 1;
+    return INVALID_CODE_POINT;
+  }
+  for(int i = 1; i < len; ++i) {
+    unsigned char cc = str[pos + i];
+    if((cc & 0xC0) != 0x80) {
+      pos += 1;
+      return INVALID_CODE_POINT;
+    }
+    cp = (cp << 6) | (cc & 0x3F);
+  }
+  pos += len;
+  return cp;
+}
+
+
+static void append_code_point(std::string& out, unsigned int cp) {
+  if(cp < 0x80) {
+    out += (char) cp;
+  } else if(cp < 0x800) {
+    out += (char) (0xC0 | (cp >> 6));
+    out += (char) (0x80 | (cp & 0x3F));
+  } else if(cp < 0x10000) {
+    out += (char) (0xE0 | (cp >> 12));
+    out += (char) (0x80 | ((cp >> 6) & 0x3F));
+    out += (char) (0x80 | (cp & 0x3F));
+  } else {
+    out += (char) (0xF0 | (cp >> 18));
+    out += (char) (0x80 | ((cp >> 12) & 0x3F));
+    out += (char) (0x80 | ((cp >> 6) & 0x3F));
+    out += (char) (0x80 | (cp & 0x3F));
+  }
+}
+
+
+static bool is_space_code_point(unsigned int cp) {
+  return cp == ' ' || cp == '\t' || cp == '\n' || cp == '\r' ||
+    cp == '\f' || cp == '\v' || cp == 0xA0 || cp == 0x3000 ||
+    (cp >= 0x2000 && cp <= 0x200B) || cp == 0xFEFF;
+}
+
+
+static bool is_punct_code_point(unsigned int cp) {
+  // ASCII punctuation.
+  if((cp >= 0x21 && cp <= 0x2F) || (cp >= 0x3A && cp <= 0x40) ||
+     (cp >= 0x5B && cp <= 0x60) || (cp >= 0x7B && cp <= 0x7E)) {
+    return true;
+  }
+  // Middle dot, general punctuation, CJK symbols and punctuation, CJK
+  // compatibility forms, full-width and half-width punctuation.
+  return cp == 0xB7 ||
+    (cp >= 0x2010 && cp <= 0x206F) ||
+    (cp >= 0x3001 && cp <= 0x3003) ||
+    (cp >= 0x3008 && cp <= 0x3011) ||
+    (cp >= 0x3014 && cp <= 0x301F) ||
+    (cp >= 0xFE30 && cp <= 0xFE4F) ||
+    (cp >= 0xFF01 && cp <= 0xFF0F) ||
+    (cp >= 0xFF1A && cp <= 0xFF20) ||
+    (cp >= 0xFF3B && cp <= 0xFF40) ||
+    (cp >= 0xFF5B && cp <= 0xFF65);
+}
+
+
+// Fold full-width ASCII and the ideographic space to half-width.
+static unsigned int fold_width(unsigned int cp) {
+  if(cp >= 0xFF01 && cp <= 0xFF5E) {
+    return cp - 0xFEE0;
+  } else if(cp == 0x3000) {
+    return ' ';
+  }
+  return cp;
+}
+
+
+// Separators that are part of a house or unit number when they sit between
+// two digits ("3-5号", "12#3", "5/2"), and so are kept by the punctuation
+// step there.
+static bool is_number_sep_code_point(unsigned int cp) {
+  return cp == '-' || cp == '#' || cp == '/';
+}
+
+
+// True if the next code point at or after str[pos], skipping whitespace if
+// "whitespace" is set, is an ASCII digit.
+static bool next_is_digit(const std::string& str, size_t pos, bool width,
+                          bool whitespace) {
+  while(pos < str.size()) {
+    unsigned int cp = next_code_point(str, pos);
+    if(width) {
+      cp = fold_width(cp);
+    }
+    if(whitespace && is_space_code_point(cp)) {
+      continue;
+    }
+    return cp >= '0' && cp <= '9';
+  }
+  return false;
+}
+
+
+// Canonical form of a single location string. Folds full-width ASCII to
+// half-width, and optionally drops whitespace, drops punctuation, and
+// lower-cases ASCII letters. The separators "-", "#" and "/" are kept
+// between two digits, so distinct numbers such as "3-5号" and "35号" do not
+// collapse onto the same string.
+std::string normalize_location(const std::string& str, bool width,
+                               bool whitespace, bool punctuation,
+                               bool lower_case) {
+  std::string out;
+  out.reserve(str.size());
+  size_t pos = 0;
+  unsigned int cp;
+
+  while(pos < str.size()) {
+    cp = next_code_point(str, pos);
+    if(cp == INVALID_CODE_POINT) {
+      out += str[pos - 1];
+      continue;
+    }
+
+    if(width) {
+      cp = fold_width(cp);
+    }
+    if(whitespace && is_space_code_point(cp)) {
+      continue;
+    }
+    if(punctuation && is_punct_code_point(cp) &&
+       !(is_number_sep_code_point(cp) && !out.empty() &&
+         out[out.size() - 1] >= '0' && out[out.size() - 1] <= '9' &&
+         next_is_digit(str, pos, width, whitespace))) {
+      continue;
+    }
+    if(lower_case && cp >= 'A' && cp <= 'Z') {
+      cp += 'a' - 'A';
+    }
+
+    append_code_point(out, cp);
+  }
+
+  return out;
+}
+
+
+// [[Rcpp::export]]
+CharacterVector normalize_locations(CharacterVector& location,
+                                    bool width = true,
+                                    bool whitespace = true,
+                                    bool punctuation = true,
+                                    bool lower_case = true) {
+  int n = location.size();
+  CharacterVector out(n);
+  std::string curr_str;
+
+  for(int i = 0; i < n; ++i) {
+    if(CharacterVector::is_na(location[i])) {
+      out[i] = NA_STRING;
+      continue;
+    }
+    curr_str = Rf_translateCharUTF8(STRING_ELT(location, i));
+    out[i] = String(
+      normalize_location(curr_str, width, whitespace, punctuation, lower_case),
+      CE_UTF8
+    );
+  }
+
+  return out;
+}
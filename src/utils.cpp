@@ -1,4 +1,8 @@
 #include <Rcpp.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
 #include "baidugeo.h"
 using namespace Rcpp;
 
@@ -52,3 +56,242 @@ void get_coords_from_uri(std::string& uri) {
   addr_vars::input_lat = atof(uri.substr(0, pos).c_str());
   addr_vars::input_lng = atof(uri.substr(pos + delim.size(), uri.find("&")).c_str());
 }
+
+
+// Append "str" to "out" as a json string literal.
+void append_json_string(const std::string& str, std::string& out) {
+  out += '"';
+  for(size_t i = 0; i < str.size(); ++i) {
+    unsigned char c = str[i];
+    if(c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if(c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+
+// Append "x" to "out" as a json number, at full precision.
+void append_number(double x, std::string& out) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.17g", x);
+  out += buf;
+}
+
+
+// Value of the 4 hex digits at "str" (of a json unicode escape).
+static unsigned int hex4(const char * str) {
+  return strtoul(std::string(str, 4).c_str(), NULL, 16);
+}
+
+
+// Read the json string that starts at json[pos] (the opening quote), and
+// advance pos past the closing quote. If "out" is not NULL, the unescaped
+// string is written to it.
+static void scan_json_string(const char * json, size_t len, size_t& pos,
+                             std::string * out) {
+  ++pos;
+  while(pos < len && json[pos] != '"') {
+    if(json[pos] == '\\' && pos + 1 < len) {
+      ++pos;
+      if(out != NULL) {
+        switch(json[pos]) {
+        case 'n': *out += '\n'; break;
+        case 't': *out += '\t'; break;
+        case 'r': *out += '\r'; break;
+        case 'b': *out += '\b'; break;
+        case 'f': *out += '\f'; break;
+        case 'u':
+          if(pos + 4 < len) {
+            unsigned int cp = hex4(json + pos + 1);
+            pos += 4;
+            // Combine a UTF-16 surrogate pair into a single code point.
+            if(cp >= 0xD800 && cp <= 0xDBFF && pos + 6 < len &&
+               json[pos + 1] == '\\' && json[pos + 2] == 'u') {
+              unsigned int low = hex4(json + pos + 3);
+              if(low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                pos += 6;
+              }
+            }
+            if(cp >= 0xD800 && cp <= 0xDFFF) {
+              cp = 0xFFFD;
+            }
+            if(cp < 0x80) {
+              *out += (char) cp;
+            } else if(cp < 0x800) {
+              *out += (char) (0xC0 | (cp >> 6));
+              *out += (char) (0x80 | (cp & 0x3F));
+            } else if(cp < 0x10000) {
+              *out += (char) (0xE0 | (cp >> 12));
+              *out += (char) (0x80 | ((cp >> 6) & 0x3F));
+              *out += (char) (0x80 | (cp & 0x3F));
+            } else {
+              *out += (char) (0xF0 | (cp >> 18));
+              *out += (char) (0x80 | ((cp >> 12) & 0x3F));
+              *out += (char) (0x80 | ((cp >> 6) & 0x3F));
+              *out += (char) (0x80 | (cp & 0x3F));
+            }
+          }
+          break;
+        default: *out += json[pos];
+        }
+      }
+    } else if(out != NULL) {
+      *out += json[pos];
+    }
+    ++pos;
+  }
+  ++pos;
+}
+
+
+// Classify a single API response in one pass over its bytes, without
+// building a DOM. Keys of interest are "status", "message" (or "msg"),
+// which only count at the top level of the object (nested objects such as
+// "result" may carry keys of the same name), and "lng", at any depth. The
+// classes are:
+//   - con_error: http error, or connection failure.
+//   - throttled: status 302 (daily quota exceeded), or 401/402 (concurrency
+//     quota exceeded).
+//   - invalid_key: response has a "message" key, but no "lng" key.
+//   - success: status 0.
+//   - failure: any other response.
+ResponseClass classify_response(const char * json, size_t len) {
+  ResponseClass out;
+  out.status = NA_REAL;
+  out.has_message = false;
+
+  if(len >= 10 && strncmp(json, "con error:", 10) == 0) {
+    out.type = "con_error";
+    size_t start = 10;
+    while(start < len && isspace((unsigned char) json[start])) {
+      ++start;
+    }
+    out.message = std::string(json + start, len - start);
+    out.has_message = true;
+    return out;
+  }
+
+  bool has_status = false;
+  bool has_lng = false;
+  bool has_message_key = false;
+  std::string key;
+  size_t pos = 0;
+  int depth = 0;
+  while(pos < len) {
+    if(json[pos] != '"') {
+      if(json[pos] == '{' || json[pos] == '[') {
+        ++depth;
+      } else if(json[pos] == '}' || json[pos] == ']') {
+        --depth;
+      }
+      ++pos;
+      continue;
+    }
+
+    // Read a string, then check whether it is an object key.
+    key.clear();
+    scan_json_string(json, len, pos, &key);
+    size_t val = pos;
+    while(val < len && isspace((unsigned char) json[val])) {
+      ++val;
+    }
+    if(val >= len || json[val] != ':') {
+      continue;
+    }
+    ++val;
+    while(val < len && isspace((unsigned char) json[val])) {
+      ++val;
+    }
+    pos = val;
+
+    if(key == "lng") {
+      has_lng = true;
+    } else if(depth != 1) {
+      continue;
+    } else if(key == "status" && !has_status) {
+      // Status is usually a number, but some responses quote it.
+      const char * start = json + val;
+      if(val < len && json[val] == '"') {
+        ++start;
+      }
+      char * end;
+      double status = strtod(start, &end);
+      if(end != start) {
+        out.status = status;
+        has_status = true;
+      }
+    } else if((key == "message" || (key == "msg" && !out.has_message)) &&
+              val < len && json[val] == '"') {
+      has_message_key = has_message_key || key == "message";
+      out.message.clear();
+      scan_json_string(json, len, pos, &out.message);
+      out.has_message = true;
+    } else if(key == "message") {
+      has_message_key = true;
+    }
+  }
+
+  if(out.status == 302 || out.status == 401 || out.status == 402) {
+    out.type = "throttled";
+  } else if(has_message_key && !has_lng) {
+    out.type = "invalid_key";
+  } else if(out.status == 0) {
+    out.type = "success";
+  } else {
+    out.type = "failure";
+  }
+
+  return out;
+}
+
+
+// [[Rcpp::export]]
+List classify_responses(CharacterVector& json) {
+  int n = json.size();
+  NumericVector status(n);
+  CharacterVector type(n);
+  CharacterVector message(n);
+  ResponseClass curr;
+
+  for(int i = 0; i < n; ++i) {
+    if(CharacterVector::is_na(json[i])) {
+      status[i] = NA_REAL;
+      type[i] = NA_STRING;
+      message[i] = NA_STRING;
+      continue;
+    }
+    SEXP curr_json = STRING_ELT(json, i);
+    curr = classify_response(CHAR(curr_json), LENGTH(curr_json));
+    status[i] = curr.status;
+    type[i] = curr.type;
+    if(curr.has_message) {
+      message[i] = String(curr.message, CE_UTF8);
+    } else {
+      message[i] = NA_STRING;
+    }
+  }
+
+  List out = List::create(
+    Named("status") = status,
+    Named("class") = type,
+    Named("message") = message
+  );
+
+  out.attr("class") = "data.frame";
+  if(n > 0) {
+    out.attr("row.names") = seq(1, n);
+  } else {
+    out.attr("row.names") = 0;
+  }
+
+  return out;
+}